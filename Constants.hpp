@@ -1,5 +1,7 @@
 #pragma once
 #include <SFML/System.hpp>
+#include <cstddef>
+#include <cstdint>
 
 // Centralized compile-time constants.
 // Grouped by subsystem to keep readability.
@@ -7,11 +9,13 @@ namespace Constants {
 
     namespace Map {
         inline constexpr float TILE_SIZE = 32.f;
-        inline constexpr int MAP_WIDTH = 100;
-        inline constexpr int MAP_HEIGHT = 72;
+        inline constexpr int DEFAULT_MAP_WIDTH = 100;     // floor size unless the Simulation is told otherwise
+        inline constexpr int DEFAULT_MAP_HEIGHT = 72;
         inline constexpr float MINIMAP_SCALE = 2.0f;
-        inline constexpr int ROOM_ATTEMPTS = 40;
-        inline constexpr int MAX_ROOMS = 5;
+        inline constexpr int ROOM_ATTEMPTS = 40;          // per default-sized area of floor
+        inline constexpr int MAX_ROOMS = 5;               // likewise; bigger floors get proportionally more
+        inline constexpr int RESIDENT_CHUNK_RADIUS = 2;   // storage chunks kept decoded around the player
+        inline constexpr int MAX_RESIDENT_CHUNKS = 64;    // decoded chunk budget, ~4.5 KB each
     }
 
     namespace Gameplay {
@@ -40,8 +44,34 @@ namespace Constants {
         inline constexpr float MaxSpeed = 500.f;
     }
 
+    namespace Sim {
+        inline constexpr int TickRate = 60;                   // fixed simulation ticks per second
+        inline constexpr float TickDt = 1.f / TickRate;
+        inline constexpr int MaxTicksPerFrame = 5;            // drop time beyond this instead of spiralling
+
+        // Whole ticks covering `seconds`, at least one
+        inline constexpr std::uint64_t ticksFor(float seconds) {
+            float ticks = seconds * TickRate + 0.5f;
+            return ticks < 1.f ? 1 : static_cast<std::uint64_t>(ticks);
+        }
+    }
+
     namespace UI {
         inline constexpr int MinimapScale = 2;
+        inline constexpr int MinimapMaxWidth = 100;           // tiles; larger floors scroll
+        inline constexpr int MinimapMaxHeight = 72;
+        inline constexpr std::size_t MaxDamageNumbers = 128;  // oldest is dropped when full
+    }
+
+    namespace Profiler {
+        inline constexpr std::size_t FrameHistory = 1024;     // frames kept, ~17 s at 60 fps
+        inline constexpr std::size_t ZonesPerFrame = 64;      // average; zone storage is FrameHistory times this
+        inline constexpr std::size_t OverlayFrames = 240;     // bars in the overlay
+        inline constexpr float TraceSeconds = 5.f;            // how far back a trace dump goes
+    }
+
+    namespace Memory {
+        inline constexpr std::size_t FrameArenaBytes = 64 * 1024; // starting size; grows to what a frame needed
     }
 
 } // namespace Constants
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "DamageNumbers.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+
+DamageNumbers::DamageNumbers(const sf::Font& font, std::size_t capacity)
+    : font(font), ring(std::max<std::size_t>(capacity, 1)) {}
+
+void DamageNumbers::setCapacity(std::size_t capacity) {
+    ring.assign(std::max<std::size_t>(capacity, 1), Number{});
+    clear();
+}
+
+void DamageNumbers::spawn(sf::Vector2f worldPos, int value, sf::Color color, std::uint64_t tick) {
+    std::size_t slot;
+    if (count == ring.size()) {
+        slot = head; // full: reuse the oldest
+        head = (head + 1) % ring.size();
+    }
+    else {
+        slot = (head + count) % ring.size();
+        count++;
+    }
+
+    ring[slot] = { worldPos, { 0.f, -RiseSpeed }, std::max(value, 0), color, tick };
+}
+
+void DamageNumbers::expire(std::uint64_t tick) {
+    // Every number lives equally long, so the oldest always expires first
+    const float lifetime = Constants::Gameplay::DamageNumberLifetime;
+    while (count > 0 && (tick - ring[head].spawnTick) * Constants::Sim::TickDt > lifetime) {
+        head = (head + 1) % ring.size();
+        count--;
+    }
+}
+
+void DamageNumbers::bakeAtlas() {
+    atlasBaked = true;
+
+    // Ask for every glyph first; loading glyphs can grow the font's page
+    const sf::Glyph* fill[10];
+    const sf::Glyph* outline[10];
+    for (int d = 0; d < 10; ++d) {
+        fill[d] = &font.getGlyph(U'0' + d, CharacterSize, false);
+        outline[d] = &font.getGlyph(U'0' + d, CharacterSize, false, OutlineThickness);
+    }
+    for (int a = 0; a < 10; ++a)
+        for (int b = 0; b < 10; ++b)
+            kerning[a][b] = font.getKerning(U'0' + a, U'0' + b, CharacterSize);
+
+    sf::Image page = font.getTexture(CharacterSize).copyToImage();
+
+    // Lay the 20 glyphs out in one row, each with a 1px transparent border
+    const int padding = 1;
+    unsigned width = 0;
+    unsigned height = 1;
+    for (int d = 0; d < 10; ++d) {
+        for (const sf::Glyph* g : { fill[d], outline[d] }) {
+            width += static_cast<unsigned>(g->textureRect.size.x + 2 * padding);
+            height = std::max(height, static_cast<unsigned>(g->textureRect.size.y + 2 * padding));
+        }
+    }
+
+    sf::Image image(sf::Vector2u{ std::max(width, 1u), height }, sf::Color::Transparent);
+    int x = 0;
+
+    auto bake = [&](const sf::Glyph& g) {
+        BakedGlyph baked;
+        baked.bounds = g.bounds;
+        baked.texRect = sf::FloatRect(
+            sf::Vector2f{ static_cast<float>(x + padding), static_cast<float>(padding) },
+            sf::Vector2f(g.textureRect.size));
+
+        if (g.textureRect.size.x > 0 && g.textureRect.size.y > 0)
+            (void)image.copy(page, sf::Vector2u{ static_cast<unsigned>(x + padding), static_cast<unsigned>(padding) }, g.textureRect);
+
+        x += g.textureRect.size.x + 2 * padding;
+        return baked;
+    };
+
+    for (int d = 0; d < 10; ++d) {
+        digits[d].fill = bake(*fill[d]);
+        digits[d].outline = bake(*outline[d]);
+        digits[d].advance = fill[d]->advance;
+    }
+
+    atlas = sf::Texture(image.getSize());
+    atlas.update(image);
+}
+
+void DamageNumbers::appendGlyph(const BakedGlyph& glyph, sf::Vector2f pen, sf::Color color) {
+    sf::Vector2f tl = pen + glyph.bounds.position;
+    sf::Vector2f br = tl + glyph.bounds.size;
+    sf::Vector2f uv0 = glyph.texRect.position;
+    sf::Vector2f uv1 = uv0 + glyph.texRect.size;
+
+    batch.append({ tl, color, uv0 });
+    batch.append({ { br.x, tl.y }, color, { uv1.x, uv0.y } });
+    batch.append({ { tl.x, br.y }, color, { uv0.x, uv1.y } });
+    batch.append({ { tl.x, br.y }, color, { uv0.x, uv1.y } });
+    batch.append({ { br.x, tl.y }, color, { uv1.x, uv0.y } });
+    batch.append({ br, color, uv1 });
+}
+
+void DamageNumbers::draw(sf::RenderTarget& target, std::uint64_t tick) {
+    PROFILE_SCOPE("DamageNumbers::draw");
+    if (count == 0) return;
+    if (!atlasBaked) bakeAtlas();
+
+    const float lifetime = Constants::Gameplay::DamageNumberLifetime;
+    batch.clear();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const Number& n = ring[(head + i) % ring.size()];
+        float age = (tick - n.spawnTick) * Constants::Sim::TickDt;
+
+        sf::Color fillColor = n.color;
+        fillColor.a = static_cast<std::uint8_t>(255.f * std::clamp(1.f - age / lifetime, 0.f, 1.f));
+
+        // Digits most significant first
+        int digitsOut[10];
+        int len = 0;
+        int v = n.value;
+        do { digitsOut[len++] = v % 10; v /= 10; } while (v > 0 && len < 10);
+        std::reverse(digitsOut, digitsOut + len);
+
+        // Pen starts on the baseline, like sf::Text
+        sf::Vector2f origin = n.position + n.velocity * age;
+        sf::Vector2f pens[10];
+        float penX = 0.f;
+        for (int k = 0; k < len; ++k) {
+            if (k > 0) penX += kerning[digitsOut[k - 1]][digitsOut[k]];
+            pens[k] = origin + sf::Vector2f{ penX, static_cast<float>(CharacterSize) };
+            penX += digits[digitsOut[k]].advance;
+        }
+
+        // Outline under the whole number, then the fill
+        for (int k = 0; k < len; ++k)
+            appendGlyph(digits[digitsOut[k]].outline, pens[k], sf::Color::Black);
+        for (int k = 0; k < len; ++k)
+            appendGlyph(digits[digitsOut[k]].fill, pens[k], fillColor);
+    }
+
+    target.draw(batch, sf::RenderStates(&atlas));
+    PROFILE_COUNT(DrawCalls, 1);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "Constants.hpp"
+
+// Floating damage numbers kept in a fixed ring buffer.
+// A number is just value, colour, position, velocity and spawn tick; the
+// text is assembled at draw time from a small atlas of the ten digits baked
+// once from the font, and every live number goes out in one draw call.
+// When the ring is full the oldest number is overwritten.
+class DamageNumbers {
+public:
+    explicit DamageNumbers(const sf::Font& font, std::size_t capacity = Constants::UI::MaxDamageNumbers);
+
+    void spawn(sf::Vector2f worldPos, int value, sf::Color color, std::uint64_t tick);
+    void expire(std::uint64_t tick); // drops numbers older than their lifetime
+    void clear() { head = 0; count = 0; }
+    void setCapacity(std::size_t capacity); // also clears
+
+    void draw(sf::RenderTarget& target, std::uint64_t tick);
+    std::size_t size() const { return count; }
+
+private:
+    static constexpr unsigned CharacterSize = 18;
+    static constexpr float OutlineThickness = 1.f;
+    static constexpr float RiseSpeed = 30.f; // px/s
+
+    struct Number {
+        sf::Vector2f position; // where it spawned
+        sf::Vector2f velocity;
+        int value = 0;
+        sf::Color color;
+        std::uint64_t spawnTick = 0;
+    };
+
+    // Quad for one baked glyph, relative to the pen position
+    struct BakedGlyph {
+        sf::FloatRect bounds;
+        sf::FloatRect texRect;
+    };
+
+    struct Digit {
+        BakedGlyph fill;
+        BakedGlyph outline;
+        float advance = 0.f;
+    };
+
+    const sf::Font& font;
+    std::vector<Number> ring;
+    std::size_t head = 0;  // oldest
+    std::size_t count = 0;
+
+    sf::Texture atlas;
+    Digit digits[10];
+    float kerning[10][10] = {};
+    bool atlasBaked = false;
+
+    sf::VertexArray batch{ sf::PrimitiveType::Triangles };
+
+    void bakeAtlas();
+    void appendGlyph(const BakedGlyph& glyph, sf::Vector2f pen, sf::Color color);
+};
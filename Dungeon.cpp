@@ -1,11 +1,73 @@
 #include "Dungeon.hpp"
-#include <random>
+#include "Fov.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr int MinMapSize = 24; // room placement needs some slack
+    constexpr int MaxClearance = 127;
+}
 
 Dungeon::Dungeon() {
-    floorTile.setSize({ TILE_SIZE, TILE_SIZE });
-    floorTile.setFillColor(sf::Color(50, 50, 50));
-    wallTile.setSize({ TILE_SIZE, TILE_SIZE });
-    wallTile.setFillColor(sf::Color(100, 100, 100));
+    map.setResidentBudget(Constants::Map::MAX_RESIDENT_CHUNKS);
+    resize(Constants::Map::DEFAULT_MAP_WIDTH, Constants::Map::DEFAULT_MAP_HEIGHT);
+}
+
+void Dungeon::resize(int width, int height) {
+    map.reset(width, height, Tile::Wall);
+    discovered.resize(width, height);
+    visible.resize(width, height);
+
+    chunksX = (width + ChunkSize - 1) / ChunkSize;
+    chunksY = (height + ChunkSize - 1) / ChunkSize;
+    chunkRevision.assign(static_cast<std::size_t>(chunksX) * chunksY, 0);
+    chunkDiscoveredCount.assign(chunkRevision.size(), 0);
+    chunkAnyDiscovered.resize(chunksX, chunksY);
+    chunkAllDiscovered.resize(chunksX, chunksY);
+
+    activeRegion = sf::IntRect({ 0, 0 }, { width, height });
+    focusChunkX = focusChunkY = -1;
+}
+
+void Dungeon::touchAllChunks() {
+    for (auto& rev : chunkRevision) ++rev;
+}
+
+int Dungeon::chunkTileCount(int chunkX, int chunkY) const {
+    int w = std::min(ChunkSize, getWidth() - chunkX * ChunkSize);
+    int h = std::min(ChunkSize, getHeight() - chunkY * ChunkSize);
+    return w * h;
+}
+
+void Dungeon::setFocus(int tileX, int tileY) {
+    int cx = std::clamp(tileX, 0, getWidth() - 1) >> TileMap::ChunkShift;
+    int cy = std::clamp(tileY, 0, getHeight() - 1) >> TileMap::ChunkShift;
+    if (cx == focusChunkX && cy == focusChunkY) return;
+
+    focusChunkX = cx;
+    focusChunkY = cy;
+
+    const int r = Constants::Map::RESIDENT_CHUNK_RADIUS;
+    map.makeResident(cx - r, cy - r, cx + r, cy + r);
+
+    int x0 = std::max(cx - r, 0) * TileMap::ChunkSize;
+    int y0 = std::max(cy - r, 0) * TileMap::ChunkSize;
+    int x1 = std::min((cx + r + 1) * TileMap::ChunkSize, getWidth());
+    int y1 = std::min((cy + r + 1) * TileMap::ChunkSize, getHeight());
+    activeRegion = sf::IntRect({ x0, y0 }, { x1 - x0, y1 - y0 });
+}
+
+void Dungeon::discover(int x, int y) {
+    discovered.set(x, y);
+
+    int cx = x / ChunkSize;
+    int cy = y / ChunkSize;
+    int count = ++chunkDiscoveredCount[cy * chunksX + cx];
+    chunkAnyDiscovered.set(cx, cy);
+    if (count == chunkTileCount(cx, cy))
+        chunkAllDiscovered.set(cx, cy);
 }
 
 bool Dungeon::roomOverlaps(const Room& a, const Room& b) {
@@ -14,9 +76,9 @@ bool Dungeon::roomOverlaps(const Room& a, const Room& b) {
 }
 
 void Dungeon::carveRoom(const Room& r) {
-    for (int yy = r.y; yy < r.y + r.h && yy < MAP_HEIGHT - 1; ++yy) {
-        for (int xx = r.x; xx < r.x + r.w && xx < MAP_WIDTH - 1; ++xx) {
-            map[yy][xx] = 0;
+    for (int yy = r.y; yy < r.y + r.h && yy < getHeight() - 1; ++yy) {
+        for (int xx = r.x; xx < r.x + r.w && xx < getWidth() - 1; ++xx) {
+            map.set(xx, yy, Tile::Floor);
         }
     }
 }
@@ -29,9 +91,8 @@ void Dungeon::carveCorridor(int x1, int y1, int x2, int y2) {
     while (x != x2) {
         for (int dy = -1; dy <= 1; ++dy) {
             int ny = y + dy;
-            if (ny >= 0 && ny < MAP_HEIGHT && map[ny][x] == 1) {
-                map[ny][x] = 0;
-            }
+            if (ny >= 0 && ny < getHeight())
+                map.set(x, ny, Tile::Floor);
         }
         x += (x2 > x) ? 1 : -1;
     }
@@ -40,31 +101,36 @@ void Dungeon::carveCorridor(int x1, int y1, int x2, int y2) {
     while (y != y2) {
         for (int dx = -1; dx <= 1; ++dx) {
             int nx = x + dx;
-            if (nx >= 0 && nx < MAP_WIDTH && map[y][nx] == 1) {
-                map[y][nx] = 0;
-            }
+            if (nx >= 0 && nx < getWidth())
+                map.set(nx, y, Tile::Floor);
         }
         y += (y2 > y) ? 1 : -1;
     }
 }
 
-void Dungeon::generate() {
+void Dungeon::generate(RandomStream& rng, int width, int height) {
+    width = std::max(width, MinMapSize);
+    height = std::max(height, MinMapSize);
 
-    for (auto& row : map) row.fill(1);
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> roomXDist(1, MAP_WIDTH - 10);
-    std::uniform_int_distribution<int> roomYDist(1, MAP_HEIGHT - 10);
-    std::uniform_int_distribution<int> roomWidth(8, 16);
-    std::uniform_int_distribution<int> roomHeight(6, 12);
+    if (width != getWidth() || height != getHeight())
+        resize(width, height);
+    else
+        map.fill(Tile::Wall);
 
     rooms.clear();
-    for (auto& row : currentlyVisible) row.fill(false);
 
+    // Same room density as the default floor
+    double scale = static_cast<double>(width) * height /
+        (Constants::Map::DEFAULT_MAP_WIDTH * Constants::Map::DEFAULT_MAP_HEIGHT);
+    int maxRooms = std::max(1, static_cast<int>(std::lround(MAX_ROOMS * scale)));
+    int attempts = std::max(1, static_cast<int>(std::lround(ROOM_ATTEMPTS * scale)));
 
-    for (int i = 0; i < ROOM_ATTEMPTS && rooms.size() < MAX_ROOMS; ++i) {
-        Room r{ roomXDist(gen), roomYDist(gen), roomWidth(gen), roomHeight(gen) };
+    for (int i = 0; i < attempts && static_cast<int>(rooms.size()) < maxRooms; ++i) {
+        Room r{};
+        r.x = rng.uniformInt(1, width - 10);
+        r.y = rng.uniformInt(1, height - 10);
+        r.w = rng.uniformInt(8, 16);
+        r.h = rng.uniformInt(6, 12);
 
         bool overlaps = false;
         for (const auto& other : rooms) {
@@ -77,7 +143,6 @@ void Dungeon::generate() {
         }
     }
 
-    std::uniform_int_distribution<int> roomPicker(0, static_cast<int>(rooms.size() - 1));
     for (size_t i = 1; i < rooms.size(); ++i) {
         int closestIndex = 0;
         int minDist = std::numeric_limits<int>::max();
@@ -97,90 +162,253 @@ void Dungeon::generate() {
             rooms[closestIndex].centerX(), rooms[closestIndex].centerY());
     }
 
+    buildSpawnIndex();
+    layoutChanged();
 }
 
-void Dungeon::draw(sf::RenderWindow& window) const {
-    for (int y = 0; y < MAP_HEIGHT; ++y) {
-        for (int x = 0; x < MAP_WIDTH; ++x) {
-            if (!discovered[y][x]) continue;
+void Dungeon::buildSpawnIndex() {
+    // Counted from the storage chunks: runs for compressed ones, a popcount
+    // per row for resident ones
+    const int chunks = map.getChunksX() * map.getChunksY();
+    floorTileStart.resize(static_cast<std::size_t>(chunks) + 1);
+    std::uint32_t total = 0;
+    for (int i = 0; i < chunks; ++i) {
+        floorTileStart[i] = total;
+        total += map.countInChunk(i % map.getChunksX(), i / map.getChunksX(), Tile::Floor);
+    }
+    floorTileStart[chunks] = total;
+}
 
-            sf::RectangleShape tile = (map[y][x] == 1) ? wallTile : floorTile;
-            tile.setPosition(sf::Vector2f{ x * TILE_SIZE, y * TILE_SIZE });
+std::uint32_t Dungeon::floorTileAt(std::size_t i) const {
+    // The last chunk starting at or before i holds it
+    auto it = std::upper_bound(floorTileStart.begin(), floorTileStart.end(), static_cast<std::uint32_t>(i));
+    int chunk = static_cast<int>(it - floorTileStart.begin()) - 1;
+    int cx = chunk % map.getChunksX(), cy = chunk / map.getChunksX();
+    int local = map.findInChunk(cx, cy, Tile::Floor, static_cast<int>(i - floorTileStart[chunk]));
+    int x = (cx << TileMap::ChunkShift) + (local & (TileMap::ChunkSize - 1));
+    int y = (cy << TileMap::ChunkShift) + (local >> TileMap::ChunkShift);
+    return static_cast<std::uint32_t>(y) * getWidth() + x;
+}
 
-            if (!currentlyVisible[y][x]) {
-                tile.setFillColor(tile.getFillColor() * sf::Color(80, 80, 80, 255)); // darken
-            }
-            window.draw(tile);
-        }
-    }
+int Dungeon::getClearance(int x, int y) const {
+    if (map.isSolid(x, y)) return 0;
+    int c = 1;
+    while (c < MaxClearance && !map.anySolidInRect(x - c, y - c, x + c, y + c)) ++c;
+    return c;
+}
+
+bool Dungeon::passes(std::uint32_t tile, const SpawnQuery& query, bool knownFloor) const {
+    int x = static_cast<int>(tile % getWidth()), y = static_cast<int>(tile / getWidth());
+    if (query.clearance > MaxClearance) return false;
+    int r = query.clearance - 1;
+    if (r > 0 ? map.anySolidInRect(x - r, y - r, x + r, y + r) : !knownFloor && map.isSolid(x, y))
+        return false;
 
+    sf::Vector2f pos(static_cast<float>(x) * TILE_SIZE, static_cast<float>(y) * TILE_SIZE);
+    sf::Vector2f delta = pos - query.awayFrom;
+    float distSq = delta.x * delta.x + delta.y * delta.y;
+    if (distSq < query.minDistance * query.minDistance) return false;
+    if (query.maxDistance >= 0.f && distSq > query.maxDistance * query.maxDistance) return false;
+    return true;
 }
 
-sf::Vector2f Dungeon::findSpawnPoint() const {
-    std::vector<sf::Vector2f> floorTiles;
-    for (int y = 0; y < MAP_HEIGHT; ++y) {
-        for (int x = 0; x < MAP_WIDTH; ++x) {
-            if (map[y][x] == 0) {
-                floorTiles.emplace_back(x * TILE_SIZE, y * TILE_SIZE);
+std::size_t Dungeon::sampleFloorTiles(RandomStream& rng, std::size_t count, const SpawnQuery& query,
+    std::pmr::vector<sf::Vector2f>& out) const
+{
+    const std::size_t first = out.size();
+    const int width = getWidth();
+
+    // Candidates come from the room, from the box the distance limit allows
+    // (when that is smaller than the floor) or from the whole floor. A room
+    // is all floor inside the map's border, so its tiles are numbered row by
+    // row; floor tiles are numbered chunk by chunk.
+    const Room* room = query.room >= 0 && query.room < static_cast<int>(rooms.size()) ? &rooms[query.room] : nullptr;
+    int roomW = 0;
+    std::size_t candidates = getFloorTileCount();
+    if (room) {
+        roomW = std::max(std::min(room->x + room->w, width - 1) - room->x, 0);
+        int roomH = std::max(std::min(room->y + room->h, getHeight() - 1) - room->y, 0);
+        candidates = static_cast<std::size_t>(roomW) * roomH;
+    }
+    if (count == 0 || candidates == 0) return 0;
+    auto candidate = [&](std::size_t i) {
+        if (!room) return floorTileAt(i);
+        return static_cast<std::uint32_t>(room->y + static_cast<int>(i / roomW)) * width
+            + room->x + static_cast<int>(i % roomW);
+    };
+
+    // Tiles this call already took. Only those bits are cleared again at the
+    // end, so the pages they live in are reused by the next call. Floor
+    // candidates skip the solid check; room rects and box draws need it.
+    if (taken.getWidth() != width || taken.getHeight() != getHeight())
+        taken.resize(width, getHeight());
+    auto take = [&](std::uint32_t tile, bool knownFloor) {
+        int x = static_cast<int>(tile % width), y = static_cast<int>(tile / width);
+        if (taken.test(x, y) || !passes(tile, query, knownFloor)) return false;
+        taken.set(x, y);
+        out.emplace_back(static_cast<float>(x) * TILE_SIZE, static_cast<float>(y) * TILE_SIZE);
+        return true;
+    };
+
+    sf::IntRect box;
+    bool useBox = false;
+    if (query.maxDistance >= 0.f && query.room < 0) {
+        int reach = static_cast<int>(std::ceil(query.maxDistance / TILE_SIZE));
+        int cx = static_cast<int>(std::floor(query.awayFrom.x / TILE_SIZE));
+        int cy = static_cast<int>(std::floor(query.awayFrom.y / TILE_SIZE));
+        int x0 = std::max(cx - reach, 0), y0 = std::max(cy - reach, 0);
+        int x1 = std::min(cx + reach, width - 1), y1 = std::min(cy + reach, getHeight() - 1);
+        if (x0 > x1 || y0 > y1) return 0;
+        box = sf::IntRect({ x0, y0 }, { x1 - x0 + 1, y1 - y0 + 1 });
+        useBox = static_cast<std::size_t>(box.size.x) * box.size.y < candidates;
+    }
+
+    const bool unfiltered = query.clearance <= 1 && query.minDistance <= 0.f && query.maxDistance < 0.f;
+    if (unfiltered) {
+        // Every candidate passes, so Floyd's algorithm (a partial
+        // Fisher-Yates shuffle that keeps the picks in a set) gets
+        // min(count, candidates) distinct ones in as many draws
+        for (std::size_t j = candidates - std::min(count, candidates); j < candidates; ++j) {
+            if (!take(candidate(rng.uniformIndex(j + 1)), !room))
+                take(candidate(j), !room);
+        }
+    }
+    else {
+        // Asking for most of the candidates: the scan below is cheaper
+        const std::size_t attempts = count * 2 >= candidates ? 0 : count * 16 + 64;
+        for (std::size_t i = 0; i < attempts && out.size() - first < count; ++i) {
+            if (useBox) {
+                int x = box.position.x + rng.uniformInt(0, box.size.x - 1);
+                int y = box.position.y + rng.uniformInt(0, box.size.y - 1);
+                take(static_cast<std::uint32_t>(y) * width + x, false);
+            }
+            else {
+                take(candidate(rng.uniformIndex(candidates)), !room);
+            }
+        }
+
+        // Sampling keeps missing: the query is tight, so walk every candidate
+        // once from a random start. The floor is walked a storage chunk at a
+        // time, skipping chunks outside the box.
+        if (out.size() - first < count && room) {
+            std::size_t start = rng.uniformIndex(candidates);
+            for (std::size_t i = 0; i < candidates && out.size() - first < count; ++i)
+                take(candidate((start + i) % candidates), false);
+        }
+        else if (out.size() - first < count) {
+            const int chunksAcross = map.getChunksX();
+            const int chunks = chunksAcross * map.getChunksY();
+            const int start = static_cast<int>(rng.uniformIndex(static_cast<std::size_t>(chunks)));
+            for (int i = 0; i < chunks && out.size() - first < count; ++i) {
+                int cx = (start + i) % chunks % chunksAcross, cy = (start + i) % chunks / chunksAcross;
+                int x0 = cx << TileMap::ChunkShift, y0 = cy << TileMap::ChunkShift;
+                if (useBox && (x0 + TileMap::ChunkSize <= box.position.x || x0 >= box.position.x + box.size.x
+                    || y0 + TileMap::ChunkSize <= box.position.y || y0 >= box.position.y + box.size.y))
+                    continue;
+                map.forEachTileInChunk(cx, cy, Tile::Floor, [&](int x, int y) {
+                    if (out.size() - first < count) take(static_cast<std::uint32_t>(y) * width + x, true);
+                });
             }
         }
     }
-    if (floorTiles.empty()) return { TILE_SIZE, TILE_SIZE }; // fallback
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<std::size_t> dist(0, floorTiles.size() - 1);
-    return floorTiles[dist(gen)];
+    for (std::size_t i = first; i < out.size(); ++i)
+        taken.reset(static_cast<int>(out[i].x / TILE_SIZE), static_cast<int>(out[i].y / TILE_SIZE));
+    return out.size() - first;
+}
+
+void Dungeon::adoptLayout(Dungeon& other) {
+    if (other.getWidth() != getWidth() || other.getHeight() != getHeight())
+        resize(other.getWidth(), other.getHeight());
+
+    std::swap(map, other.map);
+    rooms.swap(other.rooms);
+    floorTileStart.swap(other.floorTileStart);
+    layoutChanged();
+}
+
+void Dungeon::layoutChanged() {
+    visible.clear();
+    fovDirty = true;
+    fovCenterX = fovCenterY = -1; // nothing lit to clear on the new map
+    focusChunkX = focusChunkY = -1;
+    activeRegion = sf::IntRect({ 0, 0 }, { getWidth(), getHeight() });
+    touchAllChunks();
+}
+
+sf::Vector2f Dungeon::findSpawnPoint(RandomStream& rng) const {
+    if (getFloorTileCount() == 0) return { TILE_SIZE, TILE_SIZE }; // fallback
+
+    std::uint32_t tile = floorTileAt(rng.uniformIndex(getFloorTileCount()));
+    return { static_cast<float>(tile % getWidth()) * TILE_SIZE, static_cast<float>(tile / getWidth()) * TILE_SIZE };
 }
 
 void Dungeon::clearDiscovery() {
-    for (auto& row : discovered) row.fill(false);
+    discovered.clear();
+    std::fill(chunkDiscoveredCount.begin(), chunkDiscoveredCount.end(), 0);
+    chunkAnyDiscovered.clear();
+    chunkAllDiscovered.clear();
+    revealLog.clear();
+    ++discoveryEpoch;
+    fovDirty = true;
+    touchAllChunks();
 }
 
 bool Dungeon::markVisible(int centerX, int centerY, int radius) {
+    PROFILE_SCOPE("Dungeon::markVisible");
     
-    centerX = std::clamp(centerX, 0, MAP_WIDTH - 1);
-    centerY = std::clamp(centerY, 0, MAP_HEIGHT - 1);
-    
-    // Clear previous frames visibility
-    for (auto& row : currentlyVisible) row.fill(false);
+    centerX = std::clamp(centerX, 0, getWidth() - 1);
+    centerY = std::clamp(centerY, 0, getHeight() - 1);
 
-    bool revealedSomething = false;
+    // Nothing to do until the player changes tile or the map changes
+    if (!fovDirty && centerX == fovCenterX && centerY == fovCenterY && radius == fovRadius)
+        return false;
 
-    sf::Vector2f from = sf::Vector2f(centerX * TILE_SIZE + TILE_SIZE / 2.f,
-        centerY * TILE_SIZE + TILE_SIZE / 2.f);
-
-    for (int dy = -radius; dy <= radius; ++dy) {
-        for (int dx = -radius; dx <= radius; ++dx) {
-            int nx = centerX + dx;
-            int ny = centerY + dy;
-            if (nx < 0 || ny < 0 || nx >= MAP_WIDTH || ny >= MAP_HEIGHT) continue;
-
-            sf::Vector2f to = sf::Vector2f(nx * TILE_SIZE + TILE_SIZE / 2.f,
-                ny * TILE_SIZE + TILE_SIZE / 2.f);
-            if (lineOfSightClear(from, to)) {
-                if (!discovered[ny][nx]) revealedSomething = true;
-                discovered[ny][nx] = true;
-                currentlyVisible[ny][nx] = true;
-            }
-        }
+    // Clear the previous field of view: its lit tiles all sit in the
+    // square of fovRadius around the old center
+    if (fovCenterX >= 0) {
+        int x0 = std::max(fovCenterX - fovRadius, 0);
+        int y0 = std::max(fovCenterY - fovRadius, 0);
+        int x1 = std::min(fovCenterX + fovRadius, getWidth() - 1);
+        int y1 = std::min(fovCenterY + fovRadius, getHeight() - 1);
+
+        for (int y = y0; y <= y1; ++y)
+            visible.clearSpan(y, x0, x1);
+        for (int cy = y0 / ChunkSize; cy <= y1 / ChunkSize; ++cy)
+            for (int cx = x0 / ChunkSize; cx <= x1 / ChunkSize; ++cx)
+                ++chunkRevision[cy * chunksX + cx];
     }
-    return revealedSomething;
-}
 
+    fovDirty = false;
+    fovCenterX = centerX;
+    fovCenterY = centerY;
+    fovRadius = radius;
 
-std::vector<sf::Vector2f> Dungeon::getFloorTiles() const {
-    std::vector<sf::Vector2f> floorTiles;
-    for (int y = 0; y < MAP_HEIGHT; ++y) {
-        for (int x = 0; x < MAP_WIDTH; ++x) {
-            if (map[y][x] == 0) {
-                floorTiles.emplace_back(x * TILE_SIZE, y * TILE_SIZE);
-            }
+    bool revealedSomething = false;
+
+    auto isBlocking = [&](int x, int y) {
+        return map.isSolid(x, y);
+    };
+
+    auto reveal = [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= getWidth() || y >= getHeight()) return;
+        if (visible.test(x, y)) return; // diagonals are visited twice
+
+        if (!discovered.test(x, y)) {
+            revealedSomething = true;
+            revealLog.push_back(y * getWidth() + x);
+            discover(x, y);
         }
-    }
-    return floorTiles;
+        visible.set(x, y);
+        ++chunkRevision[(y / ChunkSize) * chunksX + (x / ChunkSize)];
+    };
+
+    Fov::compute(centerX, centerY, radius, isBlocking, reveal);
+
+    return revealedSomething;
 }
 
+
 bool Dungeon::lineOfSightClear(const sf::Vector2f& from, const sf::Vector2f& to) const {
     sf::Vector2i fromTile = sf::Vector2i(from / TILE_SIZE);
     sf::Vector2i toTile = sf::Vector2i(to / TILE_SIZE);
@@ -195,8 +423,7 @@ bool Dungeon::lineOfSightClear(const sf::Vector2f& from, const sf::Vector2f& to)
     int y = fromTile.y;
 
     while (x != toTile.x || y != toTile.y) {
-        if (x < 0 || y < 0 || x >= MAP_WIDTH || y >= MAP_HEIGHT) return false;
-        if (map[y][x] == 1) return false;
+        if (map.isSolid(x, y)) return false; // also off the map
 
         int e2 = 2 * err;
         if (e2 > -dy) { err -= dy; x += sx; }
@@ -207,10 +434,77 @@ bool Dungeon::lineOfSightClear(const sf::Vector2f& from, const sf::Vector2f& to)
 }
 
 bool Dungeon::isTileCurrentlyVisible(int x, int y) const {
-    if (x < 0 || y < 0 || x >= MAP_WIDTH || y >= MAP_HEIGHT)
+    return visible.test(x, y); // false off the map
+}
+
+void Dungeon::writeSnapshot(SnapshotWriter& out) const {
+    map.writeSnapshot(out);
+    out.writeArray(rooms);
+    discovered.writeSnapshot(out);
+    out.writeArray(chunkDiscoveredCount);
+    chunkAnyDiscovered.writeSnapshot(out);
+    chunkAllDiscovered.writeSnapshot(out);
+}
+
+bool Dungeon::readSnapshot(SnapshotReader& in) {
+    // Everything is read and checked before this dungeon changes, so a
+    // refused snapshot leaves the floor as it was
+    TileMap loadedMap;
+    std::vector<Room> loadedRooms;
+    TileBits loadedDiscovered;
+    std::vector<std::uint16_t> loadedCounts;
+    TileBits loadedAny;
+    TileBits loadedAll;
+    loadedMap.setResidentBudget(Constants::Map::MAX_RESIDENT_CHUNKS);
+    if (!loadedMap.readSnapshot(in)) return false;
+    in.readArray(loadedRooms);
+    loadedDiscovered.readSnapshot(in);
+    in.readArray(loadedCounts);
+    loadedAny.readSnapshot(in);
+    loadedAll.readSnapshot(in);
+    if (!in.ok()) return false;
+
+    // Sizes have to agree with the map before anything indexes with them
+    const int width = loadedMap.getWidth();
+    const int height = loadedMap.getHeight();
+    const int loadedChunksX = (width + ChunkSize - 1) / ChunkSize;
+    const int loadedChunksY = (height + ChunkSize - 1) / ChunkSize;
+    bool consistent = loadedDiscovered.getWidth() == width && loadedDiscovered.getHeight() == height &&
+        loadedCounts.size() == static_cast<std::size_t>(loadedChunksX) * loadedChunksY &&
+        loadedAny.getWidth() == loadedChunksX && loadedAny.getHeight() == loadedChunksY &&
+        loadedAll.getWidth() == loadedChunksX && loadedAll.getHeight() == loadedChunksY;
+    for (const Room& r : loadedRooms)
+        consistent = consistent && r.x >= 0 && r.y >= 0 && r.w >= 0 && r.h >= 0 &&
+            r.x < width && r.y < height;
+    if (!consistent) {
+        in.fail();
         return false;
+    }
 
-    return currentlyVisible[y][x];
+    if (width != getWidth() || height != getHeight())
+        resize(width, height);
+    std::swap(map, loadedMap);
+    rooms.swap(loadedRooms);
+    std::swap(discovered, loadedDiscovered);
+    chunkDiscoveredCount.swap(loadedCounts);
+    std::swap(chunkAnyDiscovered, loadedAny);
+    std::swap(chunkAllDiscovered, loadedAll);
+
+    buildSpawnIndex(); // derived from tiles and rooms, so not worth saving
+    revealLog.clear();
+    ++discoveryEpoch;
+    layoutChanged();
+    return true;
+}
+
+void Dungeon::adoptSnapshot(Dungeon& loaded) {
+    adoptLayout(loaded);
+    std::swap(discovered, loaded.discovered);
+    chunkDiscoveredCount.swap(loaded.chunkDiscoveredCount);
+    std::swap(chunkAnyDiscovered, loaded.chunkAnyDiscovered);
+    std::swap(chunkAllDiscovered, loaded.chunkAllDiscovered);
+    revealLog.clear();
+    ++discoveryEpoch;
 }
 
 const std::vector<Room>& Dungeon::getRooms() const {
@@ -218,10 +512,7 @@ const std::vector<Room>& Dungeon::getRooms() const {
 }
 
 bool Dungeon::isFloor(int x, int y) const {
-    if (x < 0 || y < 0 || x >= MAP_WIDTH || y >= MAP_HEIGHT)
-        return false;
-
-    return map[y][x] == 0; // 0 = floor, 1 = wall
+    return !map.isSolid(x, y);
 }
 
 
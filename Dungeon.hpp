@@ -1,17 +1,17 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <array>
+#include <memory_resource>
 #include <vector>
+#include "Constants.hpp"
+#include "Random.hpp"
+#include "TileLayers.hpp"
 
-// ---- CONFIG ----
-constexpr float TILE_SIZE = 32.f;
-constexpr int MAP_WIDTH = 100;
-constexpr int MAP_HEIGHT = 72;
-constexpr float MINIMAP_SCALE = 2.0f;
-constexpr int ROOM_ATTEMPTS = 40;
-constexpr int MAX_ROOMS = 5;
-
-using MapArray = std::array<std::array<int, MAP_WIDTH>, MAP_HEIGHT>;
+// Map constants are used unqualified throughout
+using Constants::Map::TILE_SIZE;
+using Constants::Map::MINIMAP_SCALE;
+using Constants::Map::ROOM_ATTEMPTS;
+using Constants::Map::MAX_ROOMS;
 
 struct Room {
     int x, y, w, h;
@@ -19,31 +19,130 @@ struct Room {
     int centerY() const { return y + h / 2; }
 };
 
+// Which floor tiles a spawn may use. Distances are in pixels and measured
+// from a tile's top-left corner, like the positions sampleFloorTiles returns.
+struct SpawnQuery {
+    sf::Vector2f awayFrom;
+    float minDistance = 0.f;
+    float maxDistance = -1.f; // no limit
+    int clearance = 1;        // see Dungeon::getClearance
+    int room = -1;            // only this room's tiles
+};
+
 class Dungeon {
 public:
+    // Map changes are tracked in square chunks so renderers can rebuild only
+    // what changed. (Tile storage has its own, larger TileMap::ChunkSize.)
+    static constexpr int ChunkSize = 16;
+
     Dungeon();
-    void generate();
-    void draw(sf::RenderWindow& window) const;
-    sf::Vector2f findSpawnPoint() const;
-    const MapArray& getMap() const { return map; }
+
+    // Floor size is picked per floor; rooms and attempts scale with the area
+    void generate(RandomStream& rng,
+        int width = Constants::Map::DEFAULT_MAP_WIDTH,
+        int height = Constants::Map::DEFAULT_MAP_HEIGHT);
+
+    // Swaps tiles and rooms with a dungeon generated elsewhere (say, on
+    // another thread); other gets this floor's buffers back for reuse.
+    // Discovery and revisions stay with this dungeon, so views see a change.
+    void adoptLayout(Dungeon& other);
+
+    // Tiles, rooms and discovery. The spawn index is rebuilt on load; field
+    // of view and the reveal log are not saved and a load starts a new
+    // discovery epoch. A refused snapshot leaves this dungeon unchanged.
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+    // Layout and discovery of a dungeon readSnapshot() loaded, so a caller
+    // can load into a spare one and only take it once the rest checks out
+    void adoptSnapshot(Dungeon& loaded);
+
+    int getWidth() const { return map.getWidth(); }
+    int getHeight() const { return map.getHeight(); }
+    int getChunksX() const { return chunksX; }
+    int getChunksY() const { return chunksY; }
+
+    // Keeps the storage chunks around this tile decoded. Field of view,
+    // pathing and rendering stay inside the active region (in tiles).
+    void setFocus(int tileX, int tileY);
+    const sf::IntRect& getActiveRegion() const { return activeRegion; }
+
+    sf::Vector2f findSpawnPoint(RandomStream& rng) const;
+
+    std::size_t getFloorTileCount() const { return floorTileStart.empty() ? 0 : floorTileStart.back(); }
+
+    // Chebyshev distance to the nearest wall, off the map included: 0 on a
+    // wall, 1 next to one. A tile with clearance c is the centre of an open
+    // (2c - 1) x (2c - 1) square. Measured on demand from the tile map.
+    int getClearance(int x, int y) const;
+
+    // Appends up to `count` distinct tiles (top-left pixel positions) that
+    // pass the query and returns how many. Draws random candidates and only
+    // falls back to a scan of the floor when they keep missing.
+    // Uses scratch state, so one dungeon takes one call at a time.
+    std::size_t sampleFloorTiles(RandomStream& rng, std::size_t count, const SpawnQuery& query,
+        std::pmr::vector<sf::Vector2f>& out) const;
+    const TileMap& getMap() const { return map; }
     const std::vector<Room>& getRooms() const;
     std::vector<Room> rooms;
 
 
-    const auto& getDiscovered() const { return discovered; }
+    const TileBits& getDiscovered() const { return discovered; }
+    const TileBits& getVisible() const { return visible; }
     bool markVisible(int centerX, int centerY, int radius = 2);
     void clearDiscovery(); // for when restarting the game
-    std::vector<sf::Vector2f> getFloorTiles() const;
     bool lineOfSightClear(const sf::Vector2f& from, const sf::Vector2f& to) const;
-    std::array<std::array<bool, MAP_WIDTH>, MAP_HEIGHT> currentlyVisible;
     bool isTileCurrentlyVisible(int x, int y) const;
     bool isFloor(int x, int y) const;
 
+    // Bumped whenever a tile, discovered or visible flag inside the chunk changes
+    std::uint32_t getChunkRevision(int chunkX, int chunkY) const { return chunkRevision[chunkY * chunksX + chunkX]; }
+
+    // Per-chunk discovery summary, so scans can skip or fast-path whole chunks
+    bool isChunkUndiscovered(int chunkX, int chunkY) const { return !chunkAnyDiscovered.test(chunkX, chunkY); }
+    bool isChunkFullyDiscovered(int chunkX, int chunkY) const { return chunkAllDiscovered.test(chunkX, chunkY); }
+
+    // Tiles (y * getWidth() + x) in the order they were discovered. Consumers
+    // keep a cursor into it; the epoch changes when the log starts over.
+    const std::vector<int>& getRevealLog() const { return revealLog; }
+    std::uint32_t getDiscoveryEpoch() const { return discoveryEpoch; }
+
 private:
-    MapArray map;
-    sf::RectangleShape floorTile;
-    sf::RectangleShape wallTile;
-    std::array<std::array<bool, MAP_WIDTH>, MAP_HEIGHT> discovered;
+    TileMap map;
+    TileBits discovered;
+    TileBits visible;
+    int chunksX = 0;
+    int chunksY = 0;
+    std::vector<std::uint32_t> chunkRevision;
+    std::vector<std::uint16_t> chunkDiscoveredCount;
+    TileBits chunkAnyDiscovered;
+    TileBits chunkAllDiscovered;
+    sf::IntRect activeRegion;
+    int focusChunkX = -1;
+    int focusChunkY = -1;
+
+    // Field of view is recomputed only when the center, radius or map changes.
+    // Everything lit lies in the square around the old center, so clearing
+    // that box row by row is enough.
+    int fovCenterX = -1;
+    int fovCenterY = -1;
+    int fovRadius = -1;
+    bool fovDirty = true;
+    std::vector<int> revealLog;
+    std::uint32_t discoveryEpoch = 0;
+
+    // Floor tiles before each storage chunk (and the total last), so the
+    // i-th floor tile is found without keeping an index of every tile
+    std::vector<std::uint32_t> floorTileStart;
+    mutable TileBits taken; // sampleFloorTiles scratch, all clear between calls
+
+    void resize(int width, int height);
+    void touchAllChunks();
+    void layoutChanged();
+    void buildSpawnIndex();
+    std::uint32_t floorTileAt(std::size_t i) const; // y * width + x
+    bool passes(std::uint32_t tile, const SpawnQuery& query, bool knownFloor) const;
+    void discover(int x, int y);
+    int chunkTileCount(int chunkX, int chunkY) const;
 
     bool roomOverlaps(const Room& a, const Room& b);
     void carveRoom(const Room& r);
@@ -0,0 +1,89 @@
+#include "DungeonRenderer.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const sf::Color FloorColor(50, 50, 50);
+    const sf::Color WallColor(100, 100, 100);
+    const sf::Color FogTint(80, 80, 80, 255); // discovered but not currently visible
+
+    void appendQuad(sf::VertexArray& va, sf::Vector2f pos, sf::Vector2f size, sf::Color color) {
+        sf::Vector2f a = pos;
+        sf::Vector2f b{ pos.x + size.x, pos.y };
+        sf::Vector2f c{ pos.x + size.x, pos.y + size.y };
+        sf::Vector2f d{ pos.x, pos.y + size.y };
+
+        va.append({ a, color });
+        va.append({ b, color });
+        va.append({ c, color });
+        va.append({ a, color });
+        va.append({ c, color });
+        va.append({ d, color });
+    }
+}
+
+DungeonRenderer::DungeonRenderer(const Dungeon& dungeon)
+    : dungeonRef(dungeon) {}
+
+void DungeonRenderer::rebuild(int chunkX, int chunkY, Chunk& chunk) const {
+    const TileMap& map = dungeonRef.getMap();
+    const TileBits& discovered = dungeonRef.getDiscovered();
+    const TileBits& visible = dungeonRef.getVisible();
+
+    chunk.mesh.clear();
+    chunk.builtRevision = dungeonRef.getChunkRevision(chunkX, chunkY);
+    chunk.built = true;
+    if (dungeonRef.isChunkUndiscovered(chunkX, chunkY)) return;
+
+    int x0 = chunkX * Dungeon::ChunkSize;
+    int y0 = chunkY * Dungeon::ChunkSize;
+    int x1 = std::min(x0 + Dungeon::ChunkSize, dungeonRef.getWidth()) - 1;
+    int y1 = std::min(y0 + Dungeon::ChunkSize, dungeonRef.getHeight()) - 1;
+
+    for (int y = y0; y <= y1; ++y) {
+        discovered.forEachInSpan(y, x0, x1, [&](int x) {
+            sf::Color color = map.isSolid(x, y) ? WallColor : FloorColor;
+            if (!visible.test(x, y))
+                color = color * FogTint; // darken
+
+            appendQuad(chunk.mesh, { x * TILE_SIZE, y * TILE_SIZE }, { TILE_SIZE, TILE_SIZE }, color);
+        });
+    }
+}
+
+void DungeonRenderer::draw(sf::RenderTarget& target) {
+    PROFILE_SCOPE("DungeonRenderer::draw");
+    // Floor size changed: every mesh is stale
+    if (builtWidth != dungeonRef.getWidth() || builtHeight != dungeonRef.getHeight()) {
+        builtWidth = dungeonRef.getWidth();
+        builtHeight = dungeonRef.getHeight();
+        chunks.clear();
+        chunks.resize(static_cast<std::size_t>(dungeonRef.getChunksX()) * dungeonRef.getChunksY());
+    }
+
+    const sf::View& view = target.getView();
+    sf::Vector2f half = view.getSize() * 0.5f;
+    sf::Vector2f topLeft = view.getCenter() - sf::Vector2f{ std::abs(half.x), std::abs(half.y) };
+    sf::Vector2f bottomRight = view.getCenter() + sf::Vector2f{ std::abs(half.x), std::abs(half.y) };
+
+    const float chunkPixels = Dungeon::ChunkSize * TILE_SIZE;
+    int minX = std::max(0, static_cast<int>(std::floor(topLeft.x / chunkPixels)));
+    int minY = std::max(0, static_cast<int>(std::floor(topLeft.y / chunkPixels)));
+    int maxX = std::min(dungeonRef.getChunksX() - 1, static_cast<int>(std::floor(bottomRight.x / chunkPixels)));
+    int maxY = std::min(dungeonRef.getChunksY() - 1, static_cast<int>(std::floor(bottomRight.y / chunkPixels)));
+
+    lastDrawCalls = 0;
+    for (int cy = minY; cy <= maxY; ++cy) {
+        for (int cx = minX; cx <= maxX; ++cx) {
+            Chunk& chunk = chunks[cy * dungeonRef.getChunksX() + cx];
+            if (!chunk.built || chunk.builtRevision != dungeonRef.getChunkRevision(cx, cy))
+                rebuild(cx, cy, chunk);
+
+            if (chunk.mesh.getVertexCount() == 0) continue;
+            target.draw(chunk.mesh);
+            lastDrawCalls++;
+        }
+    }
+    PROFILE_COUNT(DrawCalls, lastDrawCalls);
+}
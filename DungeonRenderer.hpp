@@ -0,0 +1,32 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "Dungeon.hpp"
+
+// Draws the dungeon as one static vertex array per chunk.
+// A chunk mesh is rebuilt only when the dungeon bumps that chunk's revision,
+// and only chunks inside the current view are drawn, so only the part of
+// the map around the camera is ever read.
+class DungeonRenderer {
+public:
+    explicit DungeonRenderer(const Dungeon& dungeon);
+
+    void draw(sf::RenderTarget& target);
+    int getLastDrawCalls() const { return lastDrawCalls; }
+
+private:
+    struct Chunk {
+        sf::VertexArray mesh{ sf::PrimitiveType::Triangles };
+        std::uint32_t builtRevision = 0;
+        bool built = false;
+    };
+
+    const Dungeon& dungeonRef;
+    std::vector<Chunk> chunks;
+    int builtWidth = 0;
+    int builtHeight = 0;
+    int lastDrawCalls = 0;
+
+    void rebuild(int chunkX, int chunkY, Chunk& chunk) const;
+};
@@ -1,5 +1,5 @@
 #include "Enemy.hpp"
-#include <random>
+#include <cmath>
 
 Enemy::Enemy(const sf::Vector2f& position, const Dungeon& dungeon) : dungeonRef(&dungeon) {
     shape.setFillColor(sf::Color::Red);
@@ -7,9 +7,61 @@ Enemy::Enemy(const sf::Vector2f& position, const Dungeon& dungeon) : dungeonRef(
     speed = 100.f;
 }
 
-void Enemy::update(const sf::Vector2f& playerPos, const std::vector<Entity*>& blockers, float dt) {
-    
-    if (!dungeonRef) return;
+Enemy::Intent Enemy::decide(const sf::Vector2f& playerPos, const FlowField& pursuit, float dt) const {
+    Intent intent;
+    if (!dungeonRef || attackState == AttackState::WindingUp) return intent;
+
+    sf::Vector2f center = getCenter();
+    int tileX = static_cast<int>(center.x / TILE_SIZE);
+    int tileY = static_cast<int>(center.y / TILE_SIZE);
+
+    std::uint32_t pathCost = pursuit.getCost(tileX, tileY);
+    if (pathCost == FlowField::Unreachable || pursuit.getPathLength(tileX, tileY) > PursuitRange)
+        return intent; // too far (by walking distance) or cut off
+
+    // Next to the player: close in directly. Otherwise walk towards the
+    // centre of the next tile on the shared path.
+    sf::Vector2f direction;
+    if (pathCost <= FlowField::DiagonalCost) {
+        direction = playerPos - shape.getPosition();
+    }
+    else {
+        sf::Vector2i step = pursuit.getStep(tileX, tileY);
+        sf::Vector2f target{ (tileX + step.x + 0.5f) * TILE_SIZE, (tileY + step.y + 0.5f) * TILE_SIZE };
+        direction = target - center;
+    }
+
+    float distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    if (distance <= 0.f) return intent;
+
+    direction /= distance; // Normalize
+    sf::Vector2f movement = direction * speed * dt;
+
+    if (movement.x == 0.f && movement.y == 0.f) return intent;
+
+    // Full move first, then axis-prioritized sliding (larger component first)
+    sf::Vector2f moveX{ movement.x, 0.f };
+    sf::Vector2f moveY{ 0.f, movement.y };
+    const sf::Vector2f candidates[3] = {
+        movement,
+        std::abs(movement.x) >= std::abs(movement.y) ? moveX : moveY,
+        std::abs(movement.x) >= std::abs(movement.y) ? moveY : moveX
+    };
+
+    // Walls never move, so they can be ruled out here
+    const TileMap& map = dungeonRef->getMap();
+    sf::FloatRect currBounds = shape.getGlobalBounds();
+    for (const sf::Vector2f& move : candidates) {
+        sf::FloatRect next = currBounds;
+        next.position += move;
+        if (clearOfWalls(next, map))
+            intent.moves[intent.moveCount++] = move;
+    }
+
+    return intent;
+}
+
+void Enemy::applyIntent(const Intent& intent, const SpatialHash& blockers) {
     if (attackState == AttackState::WindingUp)
     {
 		shape.setFillColor(sf::Color(255, 120, 120));
@@ -22,94 +74,22 @@ void Enemy::update(const sf::Vector2f& playerPos, const std::vector<Entity*>& bl
         shape.setOutlineColor(sf::Color::Magenta);
     }
 
-    
-    sf::Vector2f direction = playerPos - shape.getPosition();
-    float distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-
-    if (distance > 300.f || distance <= 0.f || !hasLineOfSightTo(playerPos)) return;  // Ignore if too far
-
-        direction /= distance; // Normalize
-        sf::Vector2f movement = direction * speed * dt;
-
-        if (movement.x == 0.f && movement.y == 0.f) return;
-
-        const MapArray& map = dungeonRef->getMap();
-        sf::FloatRect currBounds = shape.getGlobalBounds();
-
-        // Try full move first
-        sf::FloatRect fullNext = currBounds;
-        fullNext.position += movement;
-        if (canMoveTo(fullNext, map, blockers)) {
-            shape.move(movement);
+    // Entities do move, so those checks happen here against the live hash
+    sf::FloatRect currBounds = shape.getGlobalBounds();
+    for (int i = 0; i < intent.moveCount; ++i) {
+        sf::FloatRect next = currBounds;
+        next.position += intent.moves[i];
+        if (!blockers.anyOverlap(next, spatialProxy)) {
+            shape.move(intent.moves[i]);
             return;
         }
-
-        // Axis-prioritized sliding: try larger component first
-        if (std::abs(movement.x) >= std::abs(movement.y)) {
-            sf::FloatRect nextX = currBounds; nextX.position.x += movement.x;
-            if (canMoveTo(nextX, map, blockers)) {
-                shape.move(sf::Vector2f{ movement.x, 0.f });
-                return;
-            }
-            sf::FloatRect nextY = currBounds; nextY.position.y += movement.y;
-            if (canMoveTo(nextY, map, blockers)) {
-                shape.move(sf::Vector2f{ 0.f, movement.y });
-                return;
-            }
-        }
-        else {
-            sf::FloatRect nextY = currBounds; nextY.position.y += movement.y;
-            if (canMoveTo(nextY, map, blockers)) {
-                shape.move(sf::Vector2f{ 0.f, movement.y });
-                return;
-            }
-            sf::FloatRect nextX = currBounds; nextX.position.x += movement.x;
-            if (canMoveTo(nextX, map, blockers)) {
-                shape.move(sf::Vector2f{ movement.x, 0.f });
-                return;
-            }
-        }
-
-        // blocked on both axes; stay put
-}
-
-bool Enemy::hasLineOfSightTo(const sf::Vector2f& target) const {
-    if (!dungeonRef) return false;
-
-    const MapArray& map = dungeonRef->getMap();
-
-    sf::Vector2i fromTile = sf::Vector2i(shape.getPosition() / TILE_SIZE);
-    sf::Vector2i toTile = sf::Vector2i(target / TILE_SIZE);
-
-    // Bresenham-style line check
-    int dx = std::abs(toTile.x - fromTile.x);
-    int dy = std::abs(toTile.y - fromTile.y);
-    int sx = (fromTile.x < toTile.x) ? 1 : -1;
-    int sy = (fromTile.y < toTile.y) ? 1 : -1;
-    int err = dx - dy;
-
-    int x = fromTile.x;
-    int y = fromTile.y;
-
-    while (x != toTile.x || y != toTile.y) {
-        if (x < 0 || y < 0 || x >= MAP_WIDTH || y >= MAP_HEIGHT) return false;
-        if (map[y][x] == 1) return false; // hit wall
-
-        int e2 = 2 * err;
-        if (e2 > -dy) { err -= dy; x += sx; }
-        if (e2 < dx) { err += dx; y += sy; }
     }
 
-    return true; // no wall hit
+    // blocked on every option; stay put
 }
 
 bool Enemy::canAttack() const {
-    return attackState == AttackState::Idle && 
-        attackCooldown.getElapsedTime() >= AttackCooldownTime;
-}
-
-void Enemy::resetAttackCooldown() {
-	attackCooldown.restart();
+    return attackState == AttackState::Idle;
 }
 
 bool Enemy::isWindingUp() const {
@@ -118,7 +98,7 @@ bool Enemy::isWindingUp() const {
 
 void Enemy::startWindup() {
     attackState = AttackState::WindingUp;
-    windupTimer.restart();
+    windupComplete = false;
 }
 
 void Enemy::cancelWindup() {
@@ -128,14 +108,11 @@ void Enemy::cancelWindup() {
 
 void Enemy::finishAttack() {
     attackState = AttackState::Cooldown;
-    attackCooldown.restart();
 }
 
-void Enemy::updateCooldown() {
-    if (attackState == AttackState::Cooldown &&
-        attackCooldown.getElapsedTime() >= AttackCooldownTime) {
+void Enemy::finishCooldown() {
+    if (attackState == AttackState::Cooldown)
         attackState = AttackState::Idle;
-    }
 }
 
 void Enemy::makeBoss()
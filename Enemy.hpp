@@ -1,21 +1,31 @@
 #pragma once
+#include "Constants.hpp"
 #include "Entity.hpp"
 #include "Dungeon.hpp"
+#include "FlowField.hpp"
 #include "Loot.hpp"
+#include "SlotMap.hpp"
 
 class Enemy : public Entity {
 public:
     Enemy(const sf::Vector2f& position, const Dungeon& dungeon);
 
-    void update(const sf::Vector2f& playerPos, const std::vector<Entity*>& blockers, float dt);
-    bool hasLineOfSightTo(const sf::Vector2f& target) const;
+    // Movement is split so the first half can run on many threads:
+    // decide() only reads this enemy, the player position and the static map;
+    // applyIntent() does everything that depends on other entities.
+    struct Intent {
+        sf::Vector2f moves[3]; // full move, then axis slides; already clear of walls
+        int moveCount = 0;
+    };
+
+    Intent decide(const sf::Vector2f& playerPos, const FlowField& pursuit, float dt) const;
+    void applyIntent(const Intent& intent, const SpatialHash& blockers);
     bool canAttack() const;
-    void resetAttackCooldown();
     bool isWindingUp() const;
     void startWindup();
     void cancelWindup();
 	void finishAttack();
-	void updateCooldown();
+	void finishCooldown();
     //bool isBoss = false;
     void makeBoss();
 
@@ -25,15 +35,16 @@ public:
         Cooldown
     };
 
-	AttackState attackState = AttackState::Idle;
+	AttackState attackState = AttackState::Cooldown; // until the spawn cooldown runs out
+	bool windupComplete = false;
+	TimerId attackTimer; // windup or cooldown, whichever is running
 
     static constexpr float AttackRange = 40.f;
+    static constexpr float PursuitRange = 400.f; // path length, not straight-line distance
     static constexpr float AttackDamageMax = 10.f;
     static constexpr float AttackDamageMin = 20.f;
-    sf::Clock attackCooldown;
-    sf::Clock windupTimer;
-    static constexpr sf::Time AttackWindupTime = sf::milliseconds(350);
-    static constexpr sf::Time AttackCooldownTime = sf::milliseconds(900);
+    static constexpr std::uint64_t AttackWindupTicks = Constants::Sim::ticksFor(0.35f);
+    static constexpr std::uint64_t AttackCooldownTicks = Constants::Sim::ticksFor(0.9f);
 
     EnemyRarity rarity = EnemyRarity::Common;
 
@@ -45,3 +56,6 @@ private:
     const Dungeon* dungeonRef = nullptr;
 
 };
+
+using EnemyPool = SlotMap<Enemy>;
+using EnemyHandle = EnemyPool::Handle;
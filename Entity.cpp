@@ -5,33 +5,6 @@ Entity::Entity() {
     shape.setFillColor(sf::Color::White);                // Default color
 }
 
-void Entity::draw(sf::RenderWindow& window) const {
-    window.draw(shape);
-
-    // Health bar
-    sf::Vector2f pos = shape.getPosition();
-    sf::Vector2f size = shape.getSize();
-
-    sf::RectangleShape barBg({ size.x, 4.f });
-    barBg.setFillColor(sf::Color(50, 0, 0));
-    barBg.setPosition(sf::Vector2f{ pos.x, pos.y - 6.f});
-
-    sf::RectangleShape barFill({ size.x * getHealthPercent(), 4.f });
-    barFill.setFillColor(sf::Color::Red);
-    barFill.setPosition(sf::Vector2f{ pos.x, pos.y - 6.f });
-
-    window.draw(barBg);
-    window.draw(barFill);
-
-    if (damageFlashTimer.getElapsedTime().asMilliseconds() < 100) {
-        sf::RectangleShape flash;
-        flash.setSize(shape.getSize());
-        flash.setPosition(shape.getPosition());
-        flash.setFillColor(sf::Color(255, 0, 0, 100));
-        window.draw(flash);
-    }
-}
-
 sf::FloatRect Entity::getBounds() const {
     return shape.getGlobalBounds();
 }
@@ -40,29 +13,35 @@ sf::Vector2f Entity::getPosition() const {
     return shape.getPosition();
 }
 
-bool Entity::canMoveTo(const sf::FloatRect& bounds, const MapArray& map, const std::vector<Entity*>& blockers) const {
-    // Wall collision
-    for (const auto& corner : {
-        sf::Vector2f{bounds.position.x, bounds.position.y},
-        sf::Vector2f{bounds.position.x + bounds.size.x, bounds.position.y},
-        sf::Vector2f{bounds.position.x, bounds.position.y + bounds.size.y},
-        sf::Vector2f{bounds.position.x + bounds.size.x, bounds.position.y + bounds.size.y}
-        }) {
-        int tileX = static_cast<int>(corner.x / TILE_SIZE);
-        int tileY = static_cast<int>(corner.y / TILE_SIZE);
-        if (tileX < 0 || tileX >= MAP_WIDTH || tileY < 0 || tileY >= MAP_HEIGHT || map[tileY][tileX] == 1)
-            return false;
-    }
-
-    // Entity collision
-    for (const Entity* other : blockers) {
-        if (other == this) continue;
-        if (bounds.findIntersection(other->getBounds()).has_value()) {
-            return false;
-        }
-    }
-
-    return true;
+Entity::SavedState Entity::saveState() const {
+    return { shape.getPosition(), speed, maxHealth, currentHealth, flashTimer, damageFlash };
+}
+
+void Entity::loadState(const SavedState& state) {
+    shape.setPosition(state.position);
+    speed = state.speed;
+    maxHealth = state.maxHealth;
+    currentHealth = state.currentHealth;
+    damageFlash = state.damageFlash;
+    flashTimer = state.flashTimer;
+}
+
+bool Entity::canMoveTo(const sf::FloatRect& bounds, const TileMap& map, const SpatialHash& blockers) const {
+    if (!clearOfWalls(bounds, map))
+        return false;
+
+    // Entity collision (only nearby proxies)
+    return !blockers.anyOverlap(bounds, spatialProxy);
+}
+
+bool Entity::clearOfWalls(const sf::FloatRect& bounds, const TileMap& map) const {
+    // Entities are smaller than a tile, so the corner tiles cover everything
+    // they touch; test those rows a word at a time
+    int x0 = static_cast<int>(bounds.position.x / TILE_SIZE);
+    int y0 = static_cast<int>(bounds.position.y / TILE_SIZE);
+    int x1 = static_cast<int>((bounds.position.x + bounds.size.x) / TILE_SIZE);
+    int y1 = static_cast<int>((bounds.position.y + bounds.size.y) / TILE_SIZE);
+    return !map.anySolidInRect(x0, y0, x1, y1);
 }
 
 
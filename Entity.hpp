@@ -1,6 +1,8 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "Dungeon.hpp"
+#include "SpatialHash.hpp"
+#include "TimerWheel.hpp"
 
 class Entity {
 public:
@@ -8,28 +10,48 @@ public:
     virtual ~Entity() = default;
 
     virtual void update() {};
-    virtual void draw(sf::RenderWindow& window) const;
 
     virtual sf::FloatRect getBounds() const;
     virtual sf::Vector2f getPosition() const;
     void setPosition(const sf::Vector2f& pos);
-    bool canMoveTo(const sf::FloatRect& bounds, const MapArray& map, const std::vector<Entity*>& blockers) const;
+    bool canMoveTo(const sf::FloatRect& bounds, const TileMap& map, const SpatialHash& blockers) const;
+    bool clearOfWalls(const sf::FloatRect& bounds, const TileMap& map) const;
     bool overlapsWith(const Entity& other) const;
     sf::FloatRect nextPositionWithMove(sf::Vector2f movement) const;
 
     void setHealth(float health) { currentHealth = std::clamp(health, 0.f, maxHealth); }
-    void takeDamage(float amount) { currentHealth = std::max(0.f, currentHealth - amount); damageFlashTimer.restart();
+    void takeDamage(float amount) { currentHealth = std::max(0.f, currentHealth - amount); damageFlash = true;
     }
+    void clearDamageFlash() { damageFlash = false; }
+    bool isDamageFlashing() const { return damageFlash; }
+    const sf::RectangleShape& getShape() const { return shape; }
     float getHealth() const { return currentHealth; }
     float getHealthPercent() const { return currentHealth / maxHealth; }
     bool isDead() const { return currentHealth <= 0.f; }
     sf::Vector2f getCenter() const;
 
+    // What a save state keeps; the look comes from the constructor. Goes to
+    // disk as raw bytes, so the padding is spelled out and zeroed.
+    struct SavedState {
+        sf::Vector2f position;
+        float speed;
+        float maxHealth;
+        float currentHealth;
+        TimerId flashTimer;
+        bool damageFlash;
+        std::uint8_t padding[3] = {};
+    };
+    SavedState saveState() const;
+    void loadState(const SavedState& state);
+
+    SpatialHash::ProxyId spatialProxy = SpatialHash::InvalidProxy;
+    TimerId flashTimer; // ends damageFlash
+
 protected:
     sf::RectangleShape shape;
     float speed = 120.f;
     float maxHealth = 100.f;
     float currentHealth = 100.f;
-    sf::Clock damageFlashTimer;
+    bool damageFlash = false;
 
 };
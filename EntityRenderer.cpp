@@ -0,0 +1,67 @@
+#include "EntityRenderer.hpp"
+#include "Profiler.hpp"
+
+namespace {
+    const sf::Color BarBackColor(50, 0, 0);
+    const sf::Color BarFillColor = sf::Color::Red;
+    const sf::Color FlashColor(255, 0, 0, 100);
+
+    void appendQuad(sf::VertexArray& va, sf::Vector2f pos, sf::Vector2f size, sf::Color color) {
+        sf::Vector2f a = pos;
+        sf::Vector2f b{ pos.x + size.x, pos.y };
+        sf::Vector2f c{ pos.x + size.x, pos.y + size.y };
+        sf::Vector2f d{ pos.x, pos.y + size.y };
+
+        va.append({ a, color });
+        va.append({ b, color });
+        va.append({ c, color });
+        va.append({ a, color });
+        va.append({ c, color });
+        va.append({ d, color });
+    }
+}
+
+EntityRenderer::EntityRenderer(const Dungeon& dungeon) : dungeonRef(dungeon) {}
+
+void EntityRenderer::append(const Entity& entity) {
+    const sf::RectangleShape& shape = entity.getShape();
+    sf::Vector2f pos = shape.getPosition();
+    sf::Vector2f size = shape.getSize();
+
+    // Outline is drawn outside the body, same as sf::RectangleShape
+    float outline = shape.getOutlineThickness();
+    if (outline > 0.f) {
+        appendQuad(batch, pos - sf::Vector2f{ outline, outline },
+            size + sf::Vector2f{ 2.f * outline, 2.f * outline }, shape.getOutlineColor());
+    }
+    appendQuad(batch, pos, size, shape.getFillColor());
+
+    // Health bar
+    sf::Vector2f barPos{ pos.x, pos.y - 6.f };
+    appendQuad(batch, barPos, { size.x, 4.f }, BarBackColor);
+    appendQuad(batch, barPos, { size.x * entity.getHealthPercent(), 4.f }, BarFillColor);
+
+    if (entity.isDamageFlashing())
+        appendQuad(batch, pos, size, FlashColor);
+}
+
+void EntityRenderer::draw(sf::RenderTarget& target, const Player& player, const EnemyPool& enemies) {
+    PROFILE_SCOPE("EntityRenderer::draw");
+    batch.clear(); // keeps its storage between frames
+
+    append(player);
+
+    for (const auto& enemy : enemies) {
+        sf::Vector2f pos = enemy.getPosition();
+
+        int tileX = static_cast<int>(pos.x / TILE_SIZE);
+        int tileY = static_cast<int>(pos.y / TILE_SIZE);
+
+        if (dungeonRef.isTileCurrentlyVisible(tileX, tileY))
+            append(enemy);
+    }
+
+    target.draw(batch);
+    PROFILE_COUNT(DrawCalls, 1);
+    lastDrawCalls = 1;
+}
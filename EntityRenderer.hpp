@@ -0,0 +1,23 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "Dungeon.hpp"
+#include "Enemy.hpp"
+#include "Player.hpp"
+
+// Draws the player and every visible enemy (body, outline, health bar and
+// damage flash) from one reused vertex array in a single draw call, so the
+// cost in draw calls stays flat however many enemies are on screen.
+class EntityRenderer {
+public:
+    explicit EntityRenderer(const Dungeon& dungeon);
+
+    void draw(sf::RenderTarget& target, const Player& player, const EnemyPool& enemies);
+    int getLastDrawCalls() const { return lastDrawCalls; }
+
+private:
+    const Dungeon& dungeonRef;
+    sf::VertexArray batch{ sf::PrimitiveType::Triangles };
+    int lastDrawCalls = 0;
+
+    void append(const Entity& entity);
+};
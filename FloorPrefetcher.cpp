@@ -0,0 +1,72 @@
+#include "FloorPrefetcher.hpp"
+#include <algorithm>
+#include <utility>
+
+void buildFloorPlan(FloorPlan& plan) {
+    const FloorKey& key = plan.key;
+    RandomStream generationRng(RandomStream::deriveKey(key.seed, RngStreamId::Generation, key.floorNumber));
+    plan.spawnRng = RandomStream(RandomStream::deriveKey(key.seed, RngStreamId::Spawning, key.floorNumber));
+
+    plan.dungeon.generate(generationRng, key.size.x, key.size.y);
+    plan.spawnPoint = plan.dungeon.findSpawnPoint(plan.spawnRng);
+
+    SpawnQuery query;
+    query.awayFrom = plan.spawnPoint;
+    query.minDistance = 200.f; // avoid spawning too close
+
+    plan.enemyPositions.clear();
+    plan.dungeon.sampleFloorTiles(plan.spawnRng, static_cast<std::size_t>(std::max(key.enemyCount, 0)),
+        query, plan.enemyPositions);
+}
+
+FloorPrefetcher::FloorPrefetcher() {
+    worker = std::thread([this] { workerLoop(); });
+}
+
+FloorPrefetcher::~FloorPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void FloorPrefetcher::request(const FloorKey& key) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (readyValid && ready.key == key) return; // already built
+        pending = key;
+    }
+    wake.notify_one();
+}
+
+bool FloorPrefetcher::take(const FloorKey& key, FloorPlan& plan) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!readyValid || !(ready.key == key))
+        return false;
+
+    std::swap(ready, plan);
+    readyValid = false;
+    return true;
+}
+
+void FloorPrefetcher::workerLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || pending.has_value(); });
+            if (stopping) return;
+            building.key = *pending;
+            pending.reset();
+        }
+
+        buildFloorPlan(building);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(building, ready);
+            readyValid = true;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "Dungeon.hpp"
+#include "Random.hpp"
+
+// Everything a floor's contents depend on
+struct FloorKey {
+    std::uint64_t seed = 0;
+    int floorNumber = 0;
+    sf::Vector2i size;
+    int enemyCount = 0;
+
+    bool operator==(const FloorKey&) const = default;
+};
+
+// A floor ready to be swapped in: layout, player start and enemy positions.
+// spawnRng continues where enemy placement left off (the boss spawn draws
+// from it later), so a plan gives the same floor whoever built it.
+struct FloorPlan {
+    FloorKey key;
+    Dungeon dungeon;
+    sf::Vector2f spawnPoint;
+    std::pmr::vector<sf::Vector2f> enemyPositions;
+    RandomStream spawnRng;
+};
+
+// Builds plan.key's floor into plan, reusing its buffers
+void buildFloorPlan(FloorPlan& plan);
+
+// One background thread that builds the next floor while the current one is
+// played. Requests replace each other; a plan that finishes for a key nobody
+// asks for any more is simply never taken.
+class FloorPrefetcher {
+public:
+    FloorPrefetcher();
+    ~FloorPrefetcher();
+
+    FloorPrefetcher(const FloorPrefetcher&) = delete;
+    FloorPrefetcher& operator=(const FloorPrefetcher&) = delete;
+
+    void request(const FloorKey& key);
+
+    // Never waits: if the floor for key is finished it is swapped into plan
+    // (which hands its old buffers back for reuse) and true is returned
+    bool take(const FloorKey& key, FloorPlan& plan);
+
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    // Guarded by `mutex`; `building` belongs to the worker while it runs
+    std::optional<FloorKey> pending;
+    FloorPlan building;
+    FloorPlan ready;
+    bool readyValid = false;
+    bool stopping = false;
+
+    void workerLoop();
+};
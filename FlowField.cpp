@@ -0,0 +1,131 @@
+#include "FlowField.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    struct Direction {
+        int dx, dy, cost;
+    };
+
+    // Ordered so that the opposite of direction i is (i + 4) % 8
+    constexpr Direction Directions[8] = {
+        {  1,  0, FlowField::StraightCost },
+        {  1,  1, FlowField::DiagonalCost },
+        {  0,  1, FlowField::StraightCost },
+        { -1,  1, FlowField::DiagonalCost },
+        { -1,  0, FlowField::StraightCost },
+        { -1, -1, FlowField::DiagonalCost },
+        {  0, -1, FlowField::StraightCost },
+        {  1, -1, FlowField::DiagonalCost },
+    };
+
+    // Step costs are below this, so a ring of buckets never wraps onto itself
+    constexpr int BucketCount = FlowField::DiagonalCost + 1;
+}
+
+bool FlowField::update(const TileMap& map, int x, int y, const sf::IntRect& region) {
+    PROFILE_SCOPE("FlowField::update");
+    if (!region.contains({ x, y }))
+        return false;
+    if (!dirty && x == goalX && y == goalY && region == window)
+        return false;
+
+    goalX = x;
+    goalY = y;
+    window = region;
+    dirty = false;
+    rebuild(map);
+    return true;
+}
+
+int FlowField::localIndex(int x, int y) const {
+    int lx = x - window.position.x;
+    int ly = y - window.position.y;
+    if (lx < 0 || ly < 0 || lx >= window.size.x || ly >= window.size.y)
+        return -1;
+    return (ly + 1) * stride + lx + 1;
+}
+
+void FlowField::rebuild(const TileMap& map) {
+    const int w = window.size.x;
+    const int h = window.size.y;
+    stride = w + 2;
+    const std::size_t tiles = static_cast<std::size_t>(stride) * (h + 2);
+
+    cost.assign(tiles, Unreachable);
+    next.assign(tiles, NoStep);
+    buckets.resize(BucketCount);
+    for (auto& bucket : buckets) bucket.clear();
+
+    // Copy the window once so the search below reads a flat byte grid
+    open.assign(tiles, 0);
+    row.resize(w);
+    for (int ly = 0; ly < h; ++ly) {
+        map.copyRow(window.position.y + ly, window.position.x, w, row.data());
+        std::uint8_t* out = &open[(ly + 1) * stride + 1];
+        for (int lx = 0; lx < w; ++lx)
+            out[lx] = row[lx] == Tile::Floor;
+    }
+
+    int offsets[8];
+    for (int dir = 0; dir < 8; ++dir)
+        offsets[dir] = Directions[dir].dy * stride + Directions[dir].dx;
+
+    // Dial's algorithm: integer edge costs, so a ring of FIFO buckets replaces
+    // the priority queue and the whole window costs O(tiles).
+    int goal = localIndex(goalX, goalY);
+    cost[goal] = 0;
+    buckets[0].push_back(goal);
+    int pending = 1;
+
+    for (std::uint32_t d = 0; pending > 0; ++d) {
+        auto& bucket = buckets[d % BucketCount];
+
+        for (std::size_t i = 0; i < bucket.size(); ++i) {
+            int tile = bucket[i];
+            --pending;
+            if (cost[tile] != d) continue; // superseded by a cheaper path
+
+            for (int dir = 0; dir < 8; ++dir) {
+                const Direction& step = Directions[dir];
+                int neighbour = tile + offsets[dir];
+                if (!open[neighbour]) continue;
+
+                // No cutting across wall corners
+                if (step.dx != 0 && step.dy != 0 &&
+                    (!open[tile + step.dx] || !open[tile + step.dy * stride]))
+                    continue;
+
+                std::uint32_t newCost = d + step.cost;
+                if (newCost >= cost[neighbour]) continue;
+
+                cost[neighbour] = newCost;
+                next[neighbour] = static_cast<std::uint8_t>((dir + 4) % 8); // back towards this tile
+                buckets[newCost % BucketCount].push_back(neighbour);
+                ++pending;
+            }
+        }
+
+        bucket.clear();
+    }
+}
+
+std::uint32_t FlowField::getCost(int x, int y) const {
+    int i = localIndex(x, y);
+    return i < 0 ? Unreachable : cost[i];
+}
+
+float FlowField::getPathLength(int x, int y) const {
+    std::uint32_t c = getCost(x, y);
+    if (c == Unreachable)
+        return std::numeric_limits<float>::infinity();
+    return static_cast<float>(c) * (TILE_SIZE / StraightCost);
+}
+
+sf::Vector2i FlowField::getStep(int x, int y) const {
+    int i = localIndex(x, y);
+    if (i < 0 || next[i] == NoStep)
+        return { 0, 0 };
+    return { Directions[next[i]].dx, Directions[next[i]].dy };
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <vector>
+#include "Dungeon.hpp"
+
+// Dijkstra map seeded from one goal tile (the player) over a window of the
+// dungeon (its active region; the whole floor on normal-sized maps). Every
+// floor tile in the window stores its path cost to the goal and the neighbour
+// to step to next, so any number of enemies can ask "which way?" in O(1) and
+// path around walls and along corridors instead of needing line of sight.
+// Tiles outside the window are unreachable.
+//
+// Costs are in tenths of a tile: 10 for a straight step, 14 for a diagonal.
+// Diagonals are only taken when both adjacent straight tiles are floor, so
+// nothing tries to squeeze past a wall corner.
+class FlowField {
+public:
+    static constexpr std::uint32_t Unreachable = 0xFFFFFFFF;
+    static constexpr int StraightCost = 10;
+    static constexpr int DiagonalCost = 14;
+
+    FlowField() = default;
+
+    // Recomputes only if the goal tile or window changed or invalidate() was
+    // called. Returns true if the field was rebuilt.
+    bool update(const TileMap& map, int goalX, int goalY, const sf::IntRect& window);
+    void invalidate() { dirty = true; }
+
+    // Path cost to the goal in tenths of a tile, Unreachable for walls/islands
+    std::uint32_t getCost(int x, int y) const;
+    float getPathLength(int x, int y) const; // in pixels
+
+    // Unit step (-1..1 per axis) towards the goal, {0,0} on the goal or unreachable
+    sf::Vector2i getStep(int x, int y) const;
+
+    sf::Vector2i getGoal() const { return { goalX, goalY }; }
+
+private:
+    // The grids below cover the window plus a one tile closed border, so the
+    // search steps by index offsets without bounds checks or divisions.
+    sf::IntRect window;               // in map tiles
+    int stride = 0;                   // window width + 2
+    std::vector<std::uint32_t> cost;  // row-major, with border
+    std::vector<std::uint8_t> next;   // direction index towards the goal, NoStep if none
+    std::vector<std::uint8_t> open;   // copy of the map: 1 = floor, border closed
+    std::vector<std::uint8_t> row;    // tile types of one window row
+    std::vector<std::vector<int>> buckets; // Dial's queue, one bucket per cost modulo
+    int goalX = -1;
+    int goalY = -1;
+    bool dirty = true;
+
+    static constexpr std::uint8_t NoStep = 0xFF;
+
+    void rebuild(const TileMap& map);
+    int localIndex(int x, int y) const; // -1 outside the window
+};
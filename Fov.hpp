@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+
+// Symmetric shadowcasting (after Albert Ford's write-up).
+// Visits each of the four quadrants row by row, narrowing the lit slope
+// range as walls are found, so the cost is proportional to the number of
+// tiles actually visible rather than to (2r+1)^2 line-of-sight traces.
+//
+// Walls that bound the lit area are revealed; floor tiles are revealed only
+// if the origin would also be visible from them (symmetry). The radius is a
+// square (Chebyshev) limit, matching the old per-tile line check.
+namespace Fov {
+
+    namespace detail {
+
+        // Slope as an exact fraction num / den with den > 0
+        struct Slope {
+            std::int64_t num;
+            std::int64_t den;
+        };
+
+        inline std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+            std::int64_t q = a / b;
+            return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+        }
+
+        inline std::int64_t ceilDiv(std::int64_t a, std::int64_t b) {
+            return -floorDiv(-a, b);
+        }
+
+        // Quadrant-local (depth, col) to map coordinates
+        struct Quadrant {
+            int dir; // 0 north, 1 east, 2 south, 3 west
+            int ox, oy;
+
+            void transform(int depth, int col, int& x, int& y) const {
+                switch (dir) {
+                case 0:  x = ox + col;   y = oy - depth; break;
+                case 1:  x = ox + depth; y = oy + col;   break;
+                case 2:  x = ox + col;   y = oy + depth; break;
+                default: x = ox - depth; y = oy + col;   break;
+                }
+            }
+        };
+
+        template <typename IsBlocking, typename Reveal>
+        void scan(const Quadrant& q, int depth, Slope start, Slope end, int radius,
+            IsBlocking& isBlocking, Reveal& reveal)
+        {
+            if (depth > radius) return;
+
+            // round_ties_up(depth * start) .. round_ties_down(depth * end)
+            std::int64_t minCol = floorDiv(2 * depth * start.num + start.den, 2 * start.den);
+            std::int64_t maxCol = ceilDiv(2 * depth * end.num - end.den, 2 * end.den);
+
+            int prev = -1; // -1 none, 0 floor, 1 wall
+            for (std::int64_t col = minCol; col <= maxCol; ++col) {
+                int x, y;
+                q.transform(depth, static_cast<int>(col), x, y);
+                bool wall = isBlocking(x, y);
+
+                bool symmetric = col * start.den >= depth * start.num &&
+                    col * end.den <= depth * end.num;
+                if (wall || symmetric)
+                    reveal(x, y);
+
+                // Slope through the near edge of this tile
+                Slope tileSlope{ 2 * col - 1, 2 * static_cast<std::int64_t>(depth) };
+
+                if (prev == 1 && !wall)
+                    start = tileSlope;
+                if (prev == 0 && wall)
+                    scan(q, depth + 1, start, tileSlope, radius, isBlocking, reveal);
+
+                prev = wall ? 1 : 0;
+            }
+
+            if (prev == 0)
+                scan(q, depth + 1, start, end, radius, isBlocking, reveal);
+        }
+    }
+
+    // isBlocking(x, y) must return true outside the map.
+    // reveal(x, y) may be called more than once for tiles on the diagonals.
+    template <typename IsBlocking, typename Reveal>
+    void compute(int originX, int originY, int radius, IsBlocking&& isBlocking, Reveal&& reveal) {
+        reveal(originX, originY);
+
+        for (int dir = 0; dir < 4; ++dir) {
+            detail::Quadrant q{ dir, originX, originY };
+            detail::scan(q, 1, detail::Slope{ -1, 1 }, detail::Slope{ 1, 1 }, radius, isBlocking, reveal);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include "FrameArena.hpp"
+#include <algorithm>
+#include <bit>
+
+FrameArena::FrameArena(std::size_t bytes)
+    : capacity(std::max<std::size_t>(bytes, 1024)),
+    buffer(new std::byte[capacity])
+{
+    arena.emplace(buffer.get(), capacity, &overflow);
+}
+
+void FrameArena::reset() {
+    if (overflow.bytes == 0) {
+        arena->release(); // back to the start of the buffer
+        return;
+    }
+
+    // Spilled this frame: one bigger buffer so the next such frame fits
+    capacity = std::bit_ceil(capacity + overflow.bytes);
+    overflow.bytes = 0;
+    grows++;
+
+    arena.reset(); // frees the spilled blocks
+    buffer.reset(new std::byte[capacity]);
+    arena.emplace(buffer.get(), capacity, &overflow);
+}
+
+void* FrameArena::Overflow::do_allocate(std::size_t size, std::size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void FrameArena::Overflow::do_deallocate(void* p, std::size_t size, std::size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
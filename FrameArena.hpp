@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include "Constants.hpp"
+
+// Scratch memory for containers that only live until the end of a frame:
+// a monotonic arena over one preallocated buffer. Give resource() to
+// std::pmr containers; reset() takes everything back at once, so nothing
+// allocated from it may be used after that. Not thread safe - only the
+// thread that resets it may allocate from it.
+//
+// A frame that needs more than the buffer holds gets the rest from the
+// heap, and the next reset() grows the buffer to cover it. After that,
+// frames like it don't touch the heap at all.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t bytes = Constants::Memory::FrameArenaBytes);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*arena; }
+    void reset();
+
+    std::size_t getCapacity() const { return capacity; }
+    std::size_t getGrowCount() const { return grows; } // resets that had to grow the buffer
+
+private:
+    // The heap, counting what it handed out since the last reset
+    class Overflow : public std::pmr::memory_resource {
+    public:
+        std::size_t bytes = 0;
+
+    private:
+        void* do_allocate(std::size_t size, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t size, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    std::size_t capacity;
+    std::size_t grows = 0;
+    std::unique_ptr<std::byte[]> buffer;
+    Overflow overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> arena;
+};
@@ -1,124 +1,123 @@
 #include "Game.hpp"
-#include "Entity.hpp"
+#include <chrono>
 #include <iostream>
-#include <fstream>
+#include <random>
+#include "Constants.hpp"
+#include "Profiler.hpp"
+
+static std::uint64_t makeRunSeed() {
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+}
+
+static sf::Color pickupColor(Pickup::Type type) {
+    switch (type) {
+    case Pickup::Type::DamageBoost: return sf::Color(255, 80, 80);  // red
+    case Pickup::Type::SpeedBoost:  return sf::Color(80, 200, 255); // cyan
+    default:                        return sf::Color(80, 255, 80);  // green
+    }
+}
 
 Game::Game()
     : window(sf::VideoMode({ 1280, 720 }), "Pixel Dungeon Rush"),
-    dungeon(),
-    player(dungeon),
-    ui(dungeon),
-	rng(std::mt19937(std::random_device{}())),
-	loot(rng)
+    sim(makeRunSeed()),
+    ui(sim.getDungeon(), font),
+    dungeonRenderer(sim.getDungeon()),
+    entityRenderer(sim.getDungeon()),
+    damageNumbers(font),
+    profilerOverlay(font)
 {
     ui.regenerateMinimap();
+    replay.begin(sim, false);
     window.setFramerateLimit(60);
-    restartGame();
 
     camera.setSize(sf::Vector2f{
         static_cast<float>(window.getSize().x),
         static_cast<float>(window.getSize().y) });
     camera.zoom(0.4f);
 
+    pickupShape.setOrigin({ 8.f, 8.f });
+    pickupShape.setOutlineThickness(1.f);
+    deathOverlay.setFillColor(sf::Color(0, 0, 0, 180));
+
     fontLoaded = font.openFromFile("assets/Kenney Future.ttf");
     if (!fontLoaded) {
         std::cerr << "Failed to load font\n";
     }
-
-    enemyDropTable = {
-    { Pickup::Type::Heal,        60.f, 20.f, 0.f },
-    { Pickup::Type::DamageBoost, 25.f, 0.3f, 6.f },
-    { Pickup::Type::SpeedBoost,  15.f, 0.25f, 6.f }
-    };
-
 }
 
 void Game::run() {
     while (window.isOpen()) {
+        Profiler::beginFrame();
         processEvents();
         update();
         render();
+        Profiler::endFrame();
     }
+    saveReplay();
 }
 
-void Game::spawnEnemies()
+void Game::saveRunStats()
 {
-    std::vector<sf::Vector2f> validTiles = dungeon.getFloorTiles();
-
-    sf::Vector2f playerPos = player.getPosition();
-
-    std::vector<sf::Vector2f> filtered;
-    for (const auto& pos : validTiles) {
-        float dx = pos.x - playerPos.x;
-        float dy = pos.y - playerPos.y;
-        float distSq = dx * dx + dy * dy;
-
-        if (distSq > 200.f * 200.f) { // avoid spawning too close
-            filtered.push_back(pos);
-        }
-    }
-
-    std::shuffle(filtered.begin(), filtered.end(), rng);
-
-    for (int i = 0; i < enemiesToSpawn && i < filtered.size(); ++i) {
-        enemies.emplace_back(filtered[i], dungeon); // or however your constructor works
-    }
-
+    const RunStats& stats = sim.getRunStats();
+
+    RunSummary run;
+    run.seed = sim.getSeed();
+    run.endedAt = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    run.runSeconds = (sim.getTick() - stats.startTick) * Constants::Sim::TickDt;
+    run.frameP50Ms = static_cast<float>(frameTimes.percentile(0.5));
+    run.frameP99Ms = static_cast<float>(frameTimes.percentile(0.99));
+    run.totalKills = static_cast<std::uint32_t>(sim.getEnemiesDefeated());
+    for (std::size_t i = 0; i < EnemyRarityCount; ++i)
+        run.killsByRarity[i] = stats.killsByRarity[i];
+    run.floorsReached = static_cast<std::uint16_t>(sim.getFloorNumber());
+    run.peakEnemies = static_cast<std::uint16_t>(std::min<std::uint32_t>(stats.peakEnemies, 0xFFFF));
+    run.killedBy = static_cast<std::uint8_t>(static_cast<int>(stats.lastHitBy) + 1);
+
+    if (!RunHistory::append(run))
+        std::cerr << "Failed to write run history\n";
 }
 
-void Game::restartGame()
+void Game::saveReplay()
 {
-	//spawnBoss();
-    player.setHealth(100.f);
-    state = GameState::Playing;
-	enemiesDefeated = 0;
-	bossAlive = true;
-	runEnded = false;
-	bossSpawned = false;
-	attackCooldown.restart();
-    ui.clearBossMarker();
-    floorNumber = 1;
-	enemiesToSpawn = 6;
-    startFloor();
+    replay.finish(sim);
+    if (!replay.save())
+        std::cerr << "Failed to write replay\n";
 }
 
-void Game::startFloor() {
-    dungeon.generate();
-    dungeon.clearDiscovery();
-
-    player.setPosition(dungeon.findSpawnPoint());
-
-    enemies.clear();
-    pickups.clear();
-
-    spawnEnemies();
-
-    enemiesKilledThisFloor = 0;
-    enemiesToClear = static_cast<int>(enemiesToSpawn * 0.4f); // 60%
-	enemiesToClearThisFloor = enemiesToClear;
-
-    ui.markMinimapDirty();
+void Game::dumpTrace()
+{
+    if (Profiler::writeChromeTrace("trace.json", Constants::Profiler::TraceSeconds))
+        std::cout << "Wrote the last " << Constants::Profiler::TraceSeconds << " s of frames to trace.json\n";
+    else
+        std::cerr << "Trace not written (profiler compiled out or file not writable)\n";
 }
 
-void Game::advanceFloor() {
-    floorNumber++;
-    enemiesToSpawn += floorNumber + 2;
-	player.setHealth(player.getHealth() + 10.f); // heal some on floor advance
-    startFloor();
+// Both run between ticks, never inside sim.step()
+void Game::quickSave()
+{
+    if (saves.quickSave(sim))
+        std::cout << "Quick-saved " << saves.getLastSize() / 1024 << " KB in " << saves.getLastSaveMillis() << " ms\n";
+    else
+        std::cerr << "Quick-save failed\n";
 }
 
-void Game::saveRunStats()
+void Game::quickLoad()
 {
-    std::ofstream file("runs.txt", std::ios::app);
-    if (!file.is_open())
+    if (!saves.quickLoad(sim)) {
+        std::cerr << "Quick-load failed\n";
         return;
+    }
+    std::cout << "Quick-loaded in " << saves.getLastLoadMillis() << " ms\n";
 
-    file << "Floor: " << floorNumber
-        << " | Enemies: " << enemiesDefeated
-        << "\n";
+    // Earlier input doesn't lead to this state, so the recording restarts here
+    replay.begin(sim, true);
 
-    file.close();
-    
+    damageNumbers.clear();
+    attackEffectShown = false;
+    pendingInput = SimInput{};
+    applySimEvents(sim.getEvents());
 }
 
 void Game::processEvents() {
@@ -139,19 +138,31 @@ void Game::processEvents() {
 					break;
 
                 case sf::Keyboard::Key::R:
-					if (state == GameState::Dead)
-                        restartGame();
+                    pendingInput.restart = true;
 					break;
 
                 case sf::Keyboard::Key::F:
-                    if (state == GameState::Playing && canAttack())
-						handlePlayerAttack();
+                    pendingInput.attack = true;
 					break;
 
                 case sf::Keyboard::Key::T:
-                    if (state == GameState::Playing && enemiesKilledThisFloor >= enemiesToClear) {
-                        advanceFloor();
-                    }
+                    pendingInput.advanceFloor = true;
+                    break;
+
+                case sf::Keyboard::Key::F3:
+                    showProfiler = !showProfiler;
+                    break;
+
+                case sf::Keyboard::Key::F4:
+                    dumpTrace();
+                    break;
+
+                case sf::Keyboard::Key::F5:
+                    quickSave();
+                    break;
+
+                case sf::Keyboard::Key::F9:
+                    quickLoad();
                     break;
 
                 default:
@@ -161,470 +172,184 @@ void Game::processEvents() {
     }
 }
 
+SimInput Game::pollInput() {
+    SimInput input = pendingInput;
+    pendingInput = SimInput{};
+
+    input.up    = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up);
+    input.down  = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down);
+    input.left  = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left);
+    input.right = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right);
+    input.speedUp = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Y);
+    input.speedDown = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::X);
+    return input;
+}
+
 void Game::handleInputDebug(float dt) {
 
     float zoomSpeed = 1.5f;
 
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Q)) camera.zoom(1.f - zoomSpeed * dt); // zoom in slowly
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::E)) camera.zoom(1.f + zoomSpeed * dt); // zoom out slowly
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Y)) player.setSpeed(player.getSpeed() + 2.f);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::X)) player.setSpeed(std::max(1.0f, player.getSpeed() - 2.f));
 }
 
 void Game::update() {
-    if (state == GameState::Dead) return; // Pause game updates
-    
-    float dt = frameClock.restart().asSeconds();
-
-    // Prepare enemy pointers for collision checks
-    std::vector<Entity*> blockers;
-    for (auto& e : enemies) blockers.push_back(&e);
-    blockers.push_back(&player); // prevent overlapping with player too
-
-    player.handleInput(blockers, dt);
-    player.avoidEnemies(enemies); // pushing
-
-    sf::Vector2f pos = player.getPosition();
-	int tileX = std::clamp(static_cast<int>(pos.x / TILE_SIZE), 0, MAP_WIDTH - 1);
-    int tileY = std::clamp(static_cast<int>(pos.y / TILE_SIZE), 0, MAP_HEIGHT - 1);
-
-    dungeon.markVisible(tileX, tileY, VisionRadiusTiles);
-    ui.markMinimapDirty();
-
-    handleEnemyAttacks(blockers, dt);
-
-    auto pit = pickups.begin();
-    while (pit != pickups.end()) {
-
-        sf::Vector2f delta = pit->position - player.getCenter();
-        float distSq = delta.x * delta.x + delta.y * delta.y;
-
-        if (distSq < pickupRadius) { // pickup radius
-
-            switch (pit->type) {
-            case Pickup::Type::Heal:
-                player.setHealth(player.getHealth() + pit->value);
-                break;
-
-            case Pickup::Type::DamageBoost:
-                player.damageBoost = { pit->value, pit->duration };
-                break;
-
-            case Pickup::Type::SpeedBoost:
-                player.speedBoost = { pit->value, pit->duration };
-                break;
-            }
-
-
-            pit = pickups.erase(pit);
-        }
-        else {
-            ++pit;
-        }
+    PROFILE_SCOPE("Game::update");
+    sf::Time frameTime = frameClock.restart();
+    float dt = frameTime.asSeconds();
+    recordTelemetry(TelemetryEvent::Kind::FrameTime, frameTime.asSeconds() * 1000.f);
+    frameTimes.add(frameTime.asSeconds() * 1000.f);
+
+    // Fixed-rate simulation: consume real time in whole ticks. Key presses
+    // go to the first tick of the frame only.
+    const sf::Time tickTime = sf::seconds(Constants::Sim::TickDt);
+    tickAccumulator += frameTime;
+
+    SimInput input = pollInput();
+    int ticks = 0;
+    while (tickAccumulator >= tickTime && ticks < Constants::Sim::MaxTicksPerFrame) {
+        replay.record(input);
+        sim.step(input, Constants::Sim::TickDt);
+        applySimEvents(sim.getEvents());
+        input.attack = input.advanceFloor = input.restart = false;
+        tickAccumulator -= tickTime;
+        ticks++;
     }
-
-    if (fontLoaded && player.getHealth() <= 0 && !runEnded) {
-        runEnded = true;
-        endRun();
+    if (ticks == Constants::Sim::MaxTicksPerFrame)
+        tickAccumulator = sf::Time::Zero; // too far behind, don't try to catch up
+
+    // No tick this frame: keep the key presses for the next one
+    if (ticks == 0) {
+        pendingInput.attack |= input.attack;
+        pendingInput.advanceFloor |= input.advanceFloor;
+        pendingInput.restart |= input.restart;
     }
 
-    if (player.isDead()) {
-        state = GameState::Dead;
-        return;
-    }
+    if (sim.getState() == Simulation::GameState::Dead) return; // Pause game updates
 
-    camera.setCenter(player.getPosition());
+    camera.setCenter(sim.getPlayer().getPosition());
     window.setView(camera);
 
 	handleInputDebug(dt);
 
-    for (auto it = damageNumbers.begin(); it != damageNumbers.end(); ) {
-        float t = it->lifetime.getElapsedTime().asSeconds();
-
-        if (t > 0.6f) {
-            it = damageNumbers.erase(it);
-            continue;
-        }
-
-        // Move
-        it->text.move(it->velocity * dt);
-
-        // Fade out
-        sf::Color c = it->text.getFillColor();
-        c.a = static_cast<std::uint8_t>(255.f * (1.f - t / 0.6f));
-        it->text.setFillColor(c);
-
-        ++it;
-    }
+    damageNumbers.expire(sim.getTick());
 
-    if (bossSpawned && bossAlive) {
-        for (const auto& enemy : enemies) {
-            if (enemy.isBoss()) {
-                ui.setBossMarker(enemy.getCenter());
-                break;
-            }
-        }
-    }
-
-	player.updateBoosts(dt);
-
-    if (player.speedBoost) {
-        player.setSpeed(140.f + player.speedBoost->value);
-    }
-    else {
-        player.setSpeed(140.f);
-	}
+    ui.setBossMarker(sim.getBossHandle());
 }
 
-void Game::render() {
-    window.clear(sf::Color::Black);
-    dungeon.draw(window);
-    player.draw(window);
-
-    for (const auto& enemy : enemies) {
+void Game::applySimEvents(const SimEvents& events) {
+    PROFILE_SCOPE("Game::applySimEvents");
+    using Kind = TelemetryEvent::Kind;
 
-        sf::Vector2f pos = enemy.getPosition();
-
-        int tileX = static_cast<int>(pos.x / TILE_SIZE);
-        int tileY = static_cast<int>(pos.y / TILE_SIZE);
-
-        if (dungeon.isTileCurrentlyVisible(tileX, tileY)) {
-            enemy.draw(window);
-        }
-    }
-
-    for (const auto& pickup : pickups) {
-        window.draw(pickup.shape);
+    for (const auto& hit : events.hits) {
+        spawnDamageNumber(hit.position, hit.amount, hit.color);
+        recordTelemetry(hit.toPlayer ? Kind::DamageTaken : Kind::DamageDealt, hit.amount, hit.position);
     }
-
-    if (attackEffect && attackEffectTimer.getElapsedTime() < AttackEffectDuration) {
-        window.draw(*attackEffect);
-    }
-    else {
-        attackEffect.reset(); // clear it
-    }
-
-    for (const auto& dn : damageNumbers) {
-        window.draw(dn.text);
+    for (const auto& kill : events.kills)
+        recordTelemetry(Kind::Kill, 0.f, kill.position, static_cast<std::uint8_t>(kill.rarity));
+    for (const auto& pickup : events.pickupsCollected)
+        recordTelemetry(Kind::PickupCollected, pickup.value, pickup.position, static_cast<std::uint8_t>(pickup.type));
+
+    if (events.attackEffect) {
+        const auto& fx = *events.attackEffect;
+        attackEffect.setRadius(fx.radius);
+        attackEffect.setOrigin(sf::Vector2f{ fx.radius, fx.radius });
+        attackEffect.setPosition(fx.position);
+        attackEffect.setFillColor(fx.color);
+        attackEffectShown = true;
+        attackEffectEndTick = sim.getTick() + AttackEffectTicks;
     }
 
-    window.setView(window.getDefaultView());
-    ui.draw(window, player);
+    if (events.floorStarted || events.revealedTiles)
+        ui.markMinimapDirty();
 
-    if (state == GameState::Dead) {
-        sf::RectangleShape overlay;
-        overlay.setSize(sf::Vector2f(window.getSize()));
-        overlay.setFillColor(sf::Color(0, 0, 0, 180));
-        window.draw(overlay);
-    }
+    if (events.floorStarted && sim.getRunStats().startTick == sim.getTick())
+        frameTimes.clear(); // a new run
 
-    if (state == GameState::Dead && fontLoaded && player.getHealth() <= 0) {
-        ui.drawDeathScreen(window, font);
+    if (events.floorStarted) {
+        replay.reserveAhead(); // the floor swap was a hitch anyway
+        const FloorSwapStats& swap = sim.getFloorSwapStats();
+        recordTelemetry(Kind::FloorStarted, swap.lastMillis, {}, swap.lastPrefetched ? 1 : 0);
     }
 
-    if (fontLoaded && !bossAlive) {
+    if (events.runEnded) {
+        damageNumbers.clear();
+        attackEffectShown = false;
         ui.clearBossMarker();
-        //ui.drawWinScreen(window, font);
-    }
-
-    if (state == GameState::Playing && enemiesKilledThisFloor >= enemiesToClear) {
-		ui.drawAdvanceFloor(window, font);
+        saveRunStats();
+        saveReplay();
+        recordTelemetry(Kind::RunEnded, static_cast<float>(sim.getEnemiesDefeated()));
     }
-
-    ui.drawFloorCounter(window, floorNumber, font);
-	ui.drawEnemyCounter(window, enemiesToClearThisFloor, enemiesDefeated, font);
-    window.display();
 }
 
-void Game::handlePlayerAttack() {
-
-    for (auto& enemy : enemies) {
-
-        sf::Vector2f playerCenter = player.getCenter();
-        sf::FloatRect enemyBounds = enemy.getBounds();
-
-        float left = enemyBounds.position.x;
-        float right = enemyBounds.position.x + enemyBounds.size.x;
-        float top = enemyBounds.position.y;
-        float bottom = enemyBounds.position.y + enemyBounds.size.y;
-
-        float closestX = std::clamp(playerCenter.x, left, right);
-        float closestY = std::clamp(playerCenter.y, top, bottom);
-
-        float dx = playerCenter.x - closestX;
-        float dy = playerCenter.y - closestY;
-        
-        float distSq = dx * dx + dy * dy;
-
-        if (distSq <= AttackRadius * AttackRadius) {
-			float Playerdamage = rollDamage(35.f, 45.f);
-            if (player.damageBoost)
-                Playerdamage += player.damageBoost->value;
-            enemy.takeDamage(Playerdamage);  // Deal damage
+void Game::recordTelemetry(TelemetryEvent::Kind kind, float value, sf::Vector2f position, std::uint8_t detail) {
+    TelemetryEvent e;
+    e.kind = kind;
+    e.detail = detail;
+    e.floor = static_cast<std::uint16_t>(sim.getFloorNumber());
+    e.tick = static_cast<std::uint32_t>(sim.getTick());
+    e.value = value;
+    e.x = position.x;
+    e.y = position.y;
+    telemetry.push(e);
+}
 
-            spawnDamageNumber(
-                enemy.getCenter(),
-                Playerdamage,
-                enemy.isBoss() ? sf::Color(255, 120, 120) : sf::Color::White
-            );
-        }
-    }
+void Game::render() {
+    PROFILE_SCOPE("Game::render");
+    const Player& player = sim.getPlayer();
+    PROFILE_COUNT(Entities, 1 + sim.getEnemies().size() + sim.getPickups().size());
 
-    bool bossKilledThisFrame = false;
-
-    // Remove dead enemies
-    auto it = enemies.begin();
-    while (it != enemies.end()) {
-        if (it->isDead()) {
-
-            if (it->isBoss()) {
-                bossKilledThisFrame = true;
-			}
-            // Spawn pickup at enemy center           
-            //if (std::uniform_real_distribution<float>(0.f, 1.f)(rng) <= PickupSpawnChance) {
-                //spawnPickup(it->getCenter());
-            //}
-
-            auto drops = loot.rollDrops(it->rarity, it->getCenter());
-
-            std::uniform_real_distribution<float> angleDist(0.f, 2.f * 3.1415926f);
-            std::uniform_real_distribution<float> radiusDist(5.f, 18.f); // tweak range 12.f, 28.f
-
-            for (auto& p : drops)
-            {              
-                float angle = angleDist(rng);
-                float radius = radiusDist(rng);
-
-                sf::Vector2f offset(
-                    std::cos(angle) * radius,
-                    std::sin(angle) * radius
-                );
-
-                pickups.emplace_back(
-                    it->getCenter() + offset,
-                    p.type,
-                    p.value,
-                    p.duration
-                );
-            }
+    window.clear(sf::Color::Black);
+    dungeonRenderer.draw(window);
+    entityRenderer.draw(window, player, sim.getEnemies());
 
-          
-            it = enemies.erase(it);
-            enemiesDefeated++;
-            enemiesKilledThisFloor++;
-            if (enemiesToClearThisFloor > 0)
-                enemiesToClearThisFloor--;
-        }
-        else {
-            ++it;
-        }
+    for (const auto& pickup : sim.getPickups()) {
+        pickupShape.setPosition(pickup.position);
+        pickupShape.setFillColor(pickupColor(pickup.type));
+        window.draw(pickupShape);
     }
+    PROFILE_COUNT(DrawCalls, sim.getPickups().size());
 
-    if (!bossSpawned && enemiesKilledThisFloor >= BossSpawnThreshold  && floorNumber % BossFloorInterval == 0) {
-        spawnBoss();
-        bossSpawned = true;
-        bossAlive = true;
+    if (attackEffectShown && sim.getTick() < attackEffectEndTick) {
+        window.draw(attackEffect);
+        PROFILE_COUNT(DrawCalls, 1);
     }
-
-    if (bossKilledThisFrame) {
-        //endRun();
-        bossAlive = false;
-        return;
+    else {
+        attackEffectShown = false; // clear it
     }
 
-    attackCooldown.restart();
-    attackEffect.emplace(AttackRadius);
-    attackEffect->setFillColor(sf::Color(0, 255, 0, 100));
-    attackEffect->setOrigin(sf::Vector2f{ AttackRadius, AttackRadius });
-    attackEffect->setPosition(player.getCenter());
-    attackEffectTimer.restart();
-
-}
-
-void Game::handleEnemyAttacks(std::vector<Entity*>& blockers, float dt)
-{
-    for (auto& enemy : enemies) {
-        enemy.update(player.getPosition(), blockers, dt);
-        enemy.updateCooldown();
-
-        sf::FloatRect playerBounds = player.getBounds();
-        sf::Vector2f enemyCenter = enemy.getCenter();
-
-
-        float left = playerBounds.position.x;
-        float right = playerBounds.position.x + playerBounds.size.x;
-        float top = playerBounds.position.y;
-        float bottom = playerBounds.position.y + playerBounds.size.y;
-
-        float closestX = std::clamp(enemyCenter.x, left, right);
-        float closestY = std::clamp(enemyCenter.y, top, bottom);
-
-        float dx = enemyCenter.x - closestX;
-        float dy = enemyCenter.y - closestY;
+    damageNumbers.draw(window, sim.getTick());
 
-        //sf::Vector2f delta = enemy.getCenter() - player.getCenter();;
-        float distSq = dx * dx + dy * dy;
-        float rangeSq = Enemy::AttackRange * Enemy::AttackRange;
-
-        if (distSq <= rangeSq)
-        {
-            if (enemy.canAttack())
-            {
-                enemy.startWindup();
-            }
-
-            if (enemy.isWindingUp() && enemy.windupTimer.getElapsedTime() >= Enemy::AttackWindupTime)
-            {
-                //player.takeDamage(EnemyContactDPS * dt); 
-                float enemyDmg = rollDamage(Enemy::AttackDamageMax, Enemy::AttackDamageMin);
-				enemyDmg += (floorNumber - 1) * 2.f; // scale with floor
-                player.takeDamage(enemyDmg);
-                
-                spawnDamageNumber(
-                    player.getCenter(),
-                    enemyDmg,
-                    sf::Color(255, 80, 80)
-                );
-
-                attackEffect.emplace(Enemy::AttackRange);
-                attackEffect->setOrigin(sf::Vector2f{ Enemy::AttackRange, Enemy::AttackRange });
-                attackEffect->setPosition(enemy.getCenter());
-                int alpha = static_cast<int>(std::clamp(enemyDmg * 10.f, 80.f, 160.f));
-                attackEffect->setFillColor(sf::Color(255, 80, 80, alpha));
-                attackEffectTimer.restart();
-
-                enemy.finishAttack();
-            }
-        }
-        else
-        {
-            enemy.cancelWindup();
-        }
-    }
-}
-
-bool Game::canAttack() const {
-    return attackCooldown.getElapsedTime().asMilliseconds() > AttackCooldownMs; 
-}
-
-void Game::spawnBoss()
-{
-    std::vector<sf::Vector2f> floorTiles = dungeon.getFloorTiles();
-    if (floorTiles.empty())
-        return;
-
-    sf::Vector2f playerPos = player.getPosition();
-
-    auto hasClearance = [&](int tx, int ty) {
-        for (int dy = -1; dy <= 1; ++dy) {
-            for (int dx = -1; dx <= 1; ++dx) {
-                int nx = tx + dx;
-                int ny = ty + dy;
-
-                if (nx < 0 || ny < 0 || nx >= MAP_WIDTH || ny >= MAP_HEIGHT)
-                    return false;
-
-                if (!dungeon.isFloor(nx, ny))
-                    return false;
-            }
-        }
-        return true;
-        };
-
-
-    std::vector<sf::Vector2f> candidates;
-    for (const auto& tilePos : floorTiles) {
-
-        int tx = static_cast<int>(tilePos.x / TILE_SIZE);
-        int ty = static_cast<int>(tilePos.y / TILE_SIZE);
-
-        if (!hasClearance(tx, ty))
-            continue;
-
-        sf::Vector2f delta = tilePos - playerPos;
-        float distSq = delta.x * delta.x + delta.y * delta.y;
-
-        if (distSq >= BossMinSpawnDist * BossMinSpawnDist &&
-            distSq <= BossMaxSpawnDist * BossMaxSpawnDist) {
-            candidates.push_back(tilePos);
-        }
-    }
+    window.setView(window.getDefaultView());
+    ui.draw(window, player, sim.getEnemies());
 
+    bool dead = sim.getState() == Simulation::GameState::Dead;
 
-    // Fallback: if no tile fits, relax the constraint
-    if (candidates.empty()) {
-        for (const auto& tilePos : floorTiles) {
-            int tx = static_cast<int>(tilePos.x / TILE_SIZE);
-            int ty = static_cast<int>(tilePos.y / TILE_SIZE);
-            if (hasClearance(tx, ty)) {
-                candidates.push_back(tilePos);
-            }
-        }
+    if (dead) {
+        deathOverlay.setSize(sf::Vector2f(window.getSize()));
+        window.draw(deathOverlay);
+        PROFILE_COUNT(DrawCalls, 1);
     }
 
-    std::uniform_int_distribution<std::size_t> dist(0, candidates.size() - 1);
-    sf::Vector2f bossPos = candidates[dist(rng)] + sf::Vector2f{ TILE_SIZE * 0.5f, TILE_SIZE * 0.5f };
-
-    enemies.emplace_back(bossPos, dungeon);
-    enemies.back().makeBoss();
-    ui.setBossMarker(bossPos);
-}
-
-void Game::endRun() {
-    state = GameState::Dead;
-    bossAlive = false; // reuse Dead for now
-    damageNumbers.clear();
-    pickups.clear();
-    attackEffect.reset();
-    ui.clearBossMarker();
-    saveRunStats();
-}
-
-float Game::rollDamage(float min, float max)
-{
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(rng);
+    HudState hud;
+    hud.floor = sim.getFloorNumber();
+    hud.enemiesToKill = sim.getEnemiesToClearThisFloor();
+    hud.enemiesKilled = sim.getEnemiesDefeated();
+    hud.showAdvance = !dead && sim.canAdvanceFloor();
+    hud.showDeath = dead && fontLoaded && player.getHealth() <= 0;
+    hud.floorSwapMicros = static_cast<int>(sim.getFloorSwapStats().lastMillis * 1000.f);
+    hud.floorSwapPrefetched = sim.getFloorSwapStats().lastPrefetched;
+    ui.drawHud(window, hud);
+    if (showProfiler)
+        profilerOverlay.draw(window);
+
+    PROFILE_SCOPE("present"); // includes waiting out the frame rate limit
+    window.display();
 }
 
 void Game::spawnDamageNumber(const sf::Vector2f& worldPos, float value, const sf::Color& color)
 {
     if (!fontLoaded) return;
 
-    damageNumbers.emplace_back(
-        font,
-        worldPos,
-        static_cast<int>(value),
-        color
-    );
-}
-
-void Game::spawnPickup(const sf::Vector2f& pos)
-{
-    if (enemyDropTable.empty())
-        return;
-
-    float totalWeight = 0.f;
-    for (const auto& e : enemyDropTable)
-        totalWeight += e.chance;
-
-    std::uniform_real_distribution<float> dist(0.f, totalWeight);
-    float roll = dist(rng);
-
-    float accum = 0.f;
-    for (const auto& e : enemyDropTable) {
-        accum += e.chance;
-        if (roll <= accum) {
-
-            pickups.emplace_back(
-                pos,
-                e.type,
-                e.value,
-                e.duration
-            );
-
-            return;
-        }
-    }
+    damageNumbers.spawn(worldPos, static_cast<int>(value), color, sim.getTick());
 }
-
-
@@ -1,120 +1,75 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include "Player.hpp"
-#include "Enemy.hpp"
-#include "Dungeon.hpp"
+#include "Constants.hpp"
+#include "Simulation.hpp"
 #include "UI.hpp"
-#include <random>
-#include "Loot.hpp"
-
-struct DamageNumber {
-    sf::Text text;
-    sf::Vector2f velocity;
-    sf::Clock lifetime;
-
-    DamageNumber(
-        const sf::Font& font,
-        const sf::Vector2f& worldPos,
-        int value,
-        const sf::Color& color
-    )
-        : text(font, std::to_string(value), 18),
-        velocity(0.f, -30.f)
-    {
-        text.setFillColor(color);
-        text.setOutlineColor(sf::Color::Black);
-        text.setOutlineThickness(1.f);
-        text.setPosition(worldPos);
-        lifetime.restart();
-    }
-};
-
-
+#include "DungeonRenderer.hpp"
+#include "EntityRenderer.hpp"
+#include "DamageNumbers.hpp"
+#include "ProfilerOverlay.hpp"
+#include "RunHistory.hpp"
+#include "Replay.hpp"
+#include "SaveSystem.hpp"
+#include "Telemetry.hpp"
+
+// SFML front end: owns the window, camera and UI, turns keyboard state into
+// SimInput and draws whatever the Simulation currently holds.
 class Game {
 public:
     Game();
     void run();
 
-    enum class GameState {
-        Playing,
-        Dead
-    };
-
-    GameState state = GameState::Playing;
-
 private:
     sf::RenderWindow window;
     sf::View camera;
     std::optional<sf::Event> event;
-    std::vector<Enemy> enemies;
     sf::Font font;
     bool fontLoaded = false;
-    std::mt19937 rng;
 	sf::Clock frameClock;
-    std::vector<Pickup> pickups;
-    std::vector<DamageNumber> damageNumbers;
-    std::vector<DropEntry> enemyDropTable;
-
+    sf::Time tickAccumulator; // real time not yet consumed by fixed sim ticks
 
-
-    Player player;
-    Dungeon dungeon;
+    Simulation sim;
     UI ui;
-	LootSystem loot;
-	bool bossAlive = true;
-	int enemiesDefeated = 0;
-    int floorNumber = 1;
-    int enemiesKilledThisFloor = 0;
-    int enemiesToClear = 0;
-    int enemiesToClearThisFloor = 0;
-	int enemiesToSpawn = 6; 
-
-    sf::Clock attackCooldown;
-    bool canAttack() const;
+    DungeonRenderer dungeonRenderer;
+    EntityRenderer entityRenderer;
+    DamageNumbers damageNumbers;
+    ProfilerOverlay profilerOverlay;
+    bool showProfiler = false; // F3; F4 writes the last few seconds to trace.json
+    SaveSystem saves;
+    Replay replay; // this session's input, written out at each death and on exit
+    TelemetryLog telemetry;
+    Histogram frameTimes{ 0.1, 2000 }; // ms, this run only
+    SimInput pendingInput; // one-shot key presses collected by processEvents
+
+    // Shapes are kept and re-set rather than built per draw, so a frame
+    // doesn't allocate their vertices
+    sf::CircleShape attackEffect;
+    bool attackEffectShown = false;
+    std::uint64_t attackEffectEndTick = 0;
+    sf::CircleShape pickupShape{ 8.f };
+    sf::RectangleShape deathOverlay;
+
+    static constexpr std::uint64_t AttackEffectTicks = Constants::Sim::ticksFor(0.1f);
 
-    std::optional<sf::CircleShape> attackEffect;
-    sf::Clock attackEffectTimer;
-
-    // Game constants
-    static constexpr float AttackRadius = 40.f;
-    static constexpr int EnemiesPerRoom = 10;
-    static constexpr float EnemyContactDPS = 30.f;
-    static constexpr int AttackCooldownMs = 500;
-	static constexpr int VisionRadiusTiles = 5;
-    sf::Time AttackEffectDuration = sf::milliseconds(100);
-	static constexpr float BossSpawnThreshold = 7; // enemies defeated before boss spawns
-	static constexpr int BossFloorInterval = 5; // spawn boss every X floors
-	bool bossSpawned = false;
-	bool runEnded = false;
-    static constexpr float BossMinSpawnDist = 6.f * TILE_SIZE;
-    static constexpr float BossMaxSpawnDist = 12.f * TILE_SIZE;
-	static constexpr float PickupSpawnChance = 0.9f; // X% chance to drop a pickup
-	float pickupRadius = 1000.f; 
-
-
-    //static constexpr sf::Time AttackCooldown = sf::milliseconds(500);
-    
     void processEvents();
     void update();
     void render();
-    void spawnEnemies();
-    void restartGame();
-    void handlePlayerAttack();
-	void handleEnemyAttacks(std::vector<Entity*>& blockers, float dt);
     void handleInputDebug(float dt);
-	void spawnBoss();
-	void endRun();
-	float rollDamage(float min, float max);
+    SimInput pollInput();
+    void applySimEvents(const SimEvents& events);
     void spawnDamageNumber(
         const sf::Vector2f& worldPos,
         float value,
         const sf::Color& color
     );
-	void spawnPickup(const sf::Vector2f& pos);
-    void startFloor();
-    void advanceFloor();
 	void saveRunStats();
+    void recordTelemetry(TelemetryEvent::Kind kind, float value,
+        sf::Vector2f position = {}, std::uint8_t detail = 0);
+    void quickSave();
+    void quickLoad();
+    void saveReplay();
+    void dumpTrace();
 
 
-};
\ No newline at end of file
+};
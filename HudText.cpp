@@ -0,0 +1,126 @@
+#include "HudText.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+
+namespace {
+    // Walks the glyphs of a single-line string the way sf::Text lays them
+    // out: pen starts at (0, characterSize) and advances by glyph + kerning.
+    template <typename Fn>
+    void forEachGlyph(const sf::Font& font, const std::string& text, unsigned size, bool bold, Fn&& fn) {
+        float x = 0.f;
+        float y = static_cast<float>(size);
+        char32_t prev = 0;
+
+        for (unsigned char ch : text) {
+            char32_t c = ch;
+            x += font.getKerning(prev, c, size, bold);
+            prev = c;
+
+            const sf::Glyph& glyph = font.getGlyph(c, size, bold);
+            if (c != U' ' && c != U'\t')
+                fn(glyph, x, y);
+            x += glyph.advance;
+        }
+    }
+}
+
+HudText::HudText(const sf::Font& font) : font(font) {}
+
+HudText::LabelId HudText::addLabel(unsigned characterSize, sf::Color color, bool bold) {
+    labels.push_back({ {}, {}, {}, characterSize, color, bold });
+    markDirty(labels.back());
+    return labels.size() - 1;
+}
+
+void HudText::setString(LabelId id, std::string_view text) {
+    Label& label = labels[id];
+    if (label.text == text) return;
+
+    label.text = text; // reuses the label's storage when it fits
+    measure(label);
+    markDirty(label);
+}
+
+void HudText::setPosition(LabelId id, sf::Vector2f position) {
+    Label& label = labels[id];
+    if (label.position == position) return;
+
+    label.position = position;
+    markDirty(label);
+}
+
+void HudText::setVisible(LabelId id, bool visible) {
+    Label& label = labels[id];
+    if (label.visible == visible) return;
+
+    label.visible = visible;
+    markDirty(label);
+}
+
+void HudText::measure(Label& label) const {
+    float minX = 0.f, minY = 0.f, maxX = 0.f, maxY = 0.f;
+    bool any = false;
+
+    forEachGlyph(font, label.text, label.characterSize, label.bold,
+        [&](const sf::Glyph& glyph, float x, float y) {
+            float left = x + glyph.bounds.position.x;
+            float top = y + glyph.bounds.position.y;
+            float right = left + glyph.bounds.size.x;
+            float bottom = top + glyph.bounds.size.y;
+
+            if (!any) { minX = left; minY = top; maxX = right; maxY = bottom; any = true; }
+            minX = std::min(minX, left);
+            minY = std::min(minY, top);
+            maxX = std::max(maxX, right);
+            maxY = std::max(maxY, bottom);
+        });
+
+    label.size = { maxX - minX, maxY - minY };
+}
+
+void HudText::appendLabel(sf::VertexArray& mesh, const Label& label) const {
+    const float padding = 1.f; // same bleed sf::Text adds around each glyph
+
+    forEachGlyph(font, label.text, label.characterSize, label.bold,
+        [&](const sf::Glyph& glyph, float x, float y) {
+            float left = label.position.x + x + glyph.bounds.position.x - padding;
+            float top = label.position.y + y + glyph.bounds.position.y - padding;
+            float right = label.position.x + x + glyph.bounds.position.x + glyph.bounds.size.x + padding;
+            float bottom = label.position.y + y + glyph.bounds.position.y + glyph.bounds.size.y + padding;
+
+            float u1 = static_cast<float>(glyph.textureRect.position.x) - padding;
+            float v1 = static_cast<float>(glyph.textureRect.position.y) - padding;
+            float u2 = static_cast<float>(glyph.textureRect.position.x + glyph.textureRect.size.x) + padding;
+            float v2 = static_cast<float>(glyph.textureRect.position.y + glyph.textureRect.size.y) + padding;
+
+            mesh.append({ { left, top }, label.color, { u1, v1 } });
+            mesh.append({ { right, top }, label.color, { u2, v1 } });
+            mesh.append({ { left, bottom }, label.color, { u1, v2 } });
+            mesh.append({ { left, bottom }, label.color, { u1, v2 } });
+            mesh.append({ { right, top }, label.color, { u2, v1 } });
+            mesh.append({ { right, bottom }, label.color, { u2, v2 } });
+        });
+}
+
+void HudText::draw(sf::RenderTarget& target) {
+    PROFILE_SCOPE("HudText::draw");
+    lastDrawCalls = 0;
+
+    for (auto& [characterSize, batch] : batches) {
+        if (batch.dirty) {
+            batch.mesh.clear();
+            for (const Label& label : labels) {
+                if (label.visible && label.characterSize == characterSize)
+                    appendLabel(batch.mesh, label);
+            }
+            batch.dirty = false;
+        }
+
+        if (batch.mesh.getVertexCount() == 0) continue;
+
+        // Fetched after layout: loading new glyphs can grow the page texture
+        target.draw(batch.mesh, sf::RenderStates(&font.getTexture(characterSize)));
+        lastDrawCalls++;
+    }
+    PROFILE_COUNT(DrawCalls, lastDrawCalls);
+}
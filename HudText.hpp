@@ -0,0 +1,56 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Retained text labels for the HUD.
+// Each label keeps its string, colour and measured size; glyph layout only
+// runs when one of those changes. Labels that share a character size share
+// the font's glyph page, so each size is one cached vertex array and one
+// draw call no matter how many labels use it.
+class HudText {
+public:
+    using LabelId = std::size_t;
+
+    explicit HudText(const sf::Font& font);
+
+    LabelId addLabel(unsigned characterSize, sf::Color color, bool bold = false);
+
+    // Setters are cheap no-ops when nothing changes
+    void setString(LabelId id, std::string_view text);
+    void setPosition(LabelId id, sf::Vector2f position);
+    void setVisible(LabelId id, bool visible);
+
+    // Same as sf::Text::getLocalBounds().size for the current string
+    sf::Vector2f getSize(LabelId id) const { return labels[id].size; }
+
+    void draw(sf::RenderTarget& target);
+    int getLastDrawCalls() const { return lastDrawCalls; }
+
+private:
+    struct Label {
+        std::string text;
+        sf::Vector2f position;
+        sf::Vector2f size;
+        unsigned characterSize;
+        sf::Color color;
+        bool bold;
+        bool visible = true;
+    };
+
+    struct Batch {
+        sf::VertexArray mesh{ sf::PrimitiveType::Triangles };
+        bool dirty = true;
+    };
+
+    const sf::Font& font;
+    std::vector<Label> labels;
+    std::map<unsigned, Batch> batches; // by character size
+    int lastDrawCalls = 0;
+
+    void measure(Label& label) const;
+    void appendLabel(sf::VertexArray& mesh, const Label& label) const;
+    void markDirty(const Label& label) { batches[label.characterSize].dirty = true; }
+};
@@ -1,6 +1,6 @@
 #include "Loot.hpp"
 
-LootSystem::LootSystem(std::mt19937& rng)
+LootSystem::LootSystem(RandomStream& rng)
     : rng(rng)
 {
     commonTable = {
@@ -41,37 +41,30 @@ const DropTable& LootSystem::getTable(EnemyRarity rarity) const {
     }
 }
 
-std::vector<Pickup> LootSystem::rollDrops(
+std::pmr::vector<DropEntry> LootSystem::rollDrops(
     EnemyRarity rarity,
-    const sf::Vector2f& position)
+    std::pmr::memory_resource* memory)
 {
-    std::vector<Pickup> result;
+    std::pmr::vector<DropEntry> result(memory);
     const DropTable& table = getTable(rarity);
 
-    std::uniform_real_distribution<float> chanceDist(0.f, 1.f);
-
-    if (chanceDist(rng) > table.dropChance)
+    if (rng.uniformFloat(0.f, 1.f) > table.dropChance)
         return result;
 
-    std::uniform_int_distribution<int> rollCountDist(
-        table.minRolls, table.maxRolls);
-
-    int rolls = rollCountDist(rng);
+    int rolls = rng.uniformInt(table.minRolls, table.maxRolls);
 
     float totalWeight = 0.f;
     for (const auto& e : table.entries)
         totalWeight += e.chance;
 
-    std::uniform_real_distribution<float> pickDist(0.f, totalWeight);
-
     for (int i = 0; i < rolls; ++i) {
 
-        float roll = pickDist(rng);
+        float roll = rng.uniformFloat(0.f, totalWeight);
 
         for (const auto& e : table.entries) {
             roll -= e.chance;
             if (roll <= 0.f) {
-                result.emplace_back(position, e.type, e.value, e.duration);
+                result.push_back(e);
                 break;
             }
         }
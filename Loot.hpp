@@ -1,13 +1,15 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <memory_resource>
 #include <vector>
-#include <random>
+#include "Random.hpp"
 
 enum class EnemyRarity {
     Common,
     Elite,
     Boss
 };
+constexpr std::size_t EnemyRarityCount = 3;
 
 struct Pickup {
     enum class Type {
@@ -21,37 +23,8 @@ struct Pickup {
     float value; // heal amount
     float duration; // for buffs
 
-    sf::CircleShape shape;
-
     Pickup(sf::Vector2f pos, Type t, float v, float d)
-        : position(pos), type(t), value(v), duration(d), shape(8.f) {
-
-        shape.setOrigin({ 8.f, 8.f });
-        shape.setPosition(position);
-        shape.setOutlineThickness(1.f);
-		shape.getOutlineColor() = sf::Color::Black;
-
-        /*switch (type) {
-        case Pickup::Type::Heal:        shape.setFillColor(sf::Color::Green); break;
-        case Pickup::Type::DamageBoost: shape.setFillColor(sf::Color::Red);   break;
-        case Pickup::Type::SpeedBoost:  shape.setFillColor(sf::Color::Cyan);  break;
-        }*/
-
-        switch (type) {
-        case Type::Heal:
-            shape.setFillColor(sf::Color(80, 255, 80)); // green
-            break;
-
-        case Type::DamageBoost:
-            shape.setFillColor(sf::Color(255, 80, 80)); // red
-            break;
-
-        case Type::SpeedBoost:
-            shape.setFillColor(sf::Color(80, 200, 255)); // cyan
-            break;
-        }
-
-    }
+        : position(pos), type(t), value(v), duration(d) {}
 };
 
 struct DropEntry {
@@ -70,15 +43,16 @@ struct DropTable {
 
 class LootSystem {
 public:
-    LootSystem(std::mt19937& rng);
+    LootSystem(RandomStream& rng);
 
-    std::vector<Pickup> rollDrops(
+    // What a kill of this rarity drops; the caller places the pickups
+    std::pmr::vector<DropEntry> rollDrops(
         EnemyRarity rarity,
-        const sf::Vector2f& position
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource()
     );
 
 private:
-    std::mt19937& rng;
+    RandomStream& rng;
 
     DropTable commonTable;
     DropTable eliteTable;
@@ -1,4 +1,26 @@
 #include "Game.hpp"
+#include "Profiler.hpp"
+#include <cstdlib>
+#include <new>
+
+#if PDR_PROFILE
+// Heap allocations on the main thread show up in the profiler; a steady
+// frame should have none. The array and nothrow forms come through here too.
+void* operator new(std::size_t size) {
+    PROFILE_COUNT(HeapAllocs, 1);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+#endif
 
 int main() {
     Game game;
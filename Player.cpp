@@ -1,5 +1,4 @@
 #include "Player.hpp"
-#include <SFML/Window/Keyboard.hpp>
 #include <cmath>
 
 Player::Player(const Dungeon& dungeon) : dungeonRef(dungeon) {
@@ -8,20 +7,20 @@ Player::Player(const Dungeon& dungeon) : dungeonRef(dungeon) {
     speed = 140.f;
 }
 
-void Player::handleInput(const std::vector<Entity*>& blockers, float dt) {
+void Player::handleInput(const SimInput& input, const SpatialHash& blockers, float dt) {
     sf::Vector2f movement{ 0.f, 0.f };
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)) movement.y -= speed;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down)) movement.y += speed;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left)) movement.x -= speed;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) movement.x += speed;
+    if (input.up)    movement.y -= speed;
+    if (input.down)  movement.y += speed;
+    if (input.left)  movement.x -= speed;
+    if (input.right) movement.x += speed;
 
 	movement *= dt;
 
     if (movement.x == 0.f && movement.y == 0.f)
         return;
 
-    const MapArray& map = dungeonRef.getMap();
+    const TileMap& map = dungeonRef.getMap();
 
     // Attempt full movement first
     sf::FloatRect currBounds = shape.getGlobalBounds();
@@ -71,13 +70,17 @@ void Player::handleInput(const std::vector<Entity*>& blockers, float dt) {
 
 }
 
-void Player::avoidEnemies(const std::vector<Enemy>& enemies) {
-    sf::FloatRect playerBounds = shape.getGlobalBounds();
-    std::vector<Entity*>blockers;
-    for (const auto& e : enemies)
-        blockers.push_back(const_cast<Enemy*>(&e));
+void Player::avoidEnemies(const SpatialHash& blockers) {
+    // Each push is at most 3px, so anything we could end up touching is
+    // already near the starting bounds.
+    sf::FloatRect area = shape.getGlobalBounds();
+    area.position -= sf::Vector2f{ TILE_SIZE, TILE_SIZE };
+    area.size += sf::Vector2f{ 2.f * TILE_SIZE, 2.f * TILE_SIZE };
+
+    blockers.query(area, [&](SpatialHash::ProxyId id) {
+        if (id == spatialProxy) return;
+        const Entity& enemy = *blockers.getOwner(id);
 
-    for (const auto& enemy : enemies) {
         if (overlapsWith(enemy)) {
             sf::Vector2f away = getPosition() - enemy.getPosition();
             float lenSq = away.x * away.x + away.y * away.y;
@@ -89,22 +92,5 @@ void Player::avoidEnemies(const std::vector<Enemy>& enemies) {
                 }
             }
         }
-    }
-}
-void Player::updateBoosts(float dt) {
-    if (damageBoost) {
-        damageBoost->remaining -= dt;
-        if (damageBoost->remaining <= 0.f)
-            damageBoost.reset();
-    }
-
-    if (speedBoost) {
-        speedBoost->remaining -= dt;
-        if (speedBoost->remaining <= 0.f)
-            speedBoost.reset();
-    }
+    });
 }
-
-
-
-
@@ -2,23 +2,23 @@
 #include "Dungeon.hpp"
 #include "Entity.hpp"
 #include "Enemy.hpp"
+#include "SimInput.hpp"
 
 struct TimedBoost {
     float value;
-    float remaining;
+    TimerId expiry;
 };
 
 class Player : public Entity{
 public:
     Player(const Dungeon& dungeon);
 
-    void handleInput(const std::vector<Entity*>& blockers, float dt);
-    void avoidEnemies(const std::vector<Enemy>& enemies);  
+    void handleInput(const SimInput& input, const SpatialHash& blockers, float dt);
+    void avoidEnemies(const SpatialHash& blockers);
 
     void setSpeed(float s) { speed = s; }
     float getSpeed() const { return speed; }
 
-	void updateBoosts(float dt);
     std::optional<TimedBoost> damageBoost;
     std::optional<TimedBoost> speedBoost;
 
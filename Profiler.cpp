@@ -0,0 +1,165 @@
+#include "Profiler.hpp"
+
+#if PDR_PROFILE
+#include "Constants.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace Profiler {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr std::size_t FrameCapacity = Constants::Profiler::FrameHistory;
+        constexpr std::size_t ZoneCapacity = FrameCapacity * Constants::Profiler::ZonesPerFrame;
+
+        // Set by the first beginFrame(); markers on any other thread are ignored
+        thread_local bool profilerThread = false;
+
+        struct State {
+            std::vector<Frame> frames = std::vector<Frame>(FrameCapacity);
+            std::vector<Zone> zones = std::vector<Zone>(ZoneCapacity);
+            std::uint64_t framesDone = 0; // finished frames ever
+            std::uint64_t zonesUsed = 0;  // zones ever begun
+            std::uint32_t depth = 0;
+            bool inFrame = false;
+            Clock::time_point origin = Clock::now();
+        };
+
+        State& state() {
+            static State s;
+            return s;
+        }
+
+        std::uint64_t nowNs(const State& s) {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - s.origin).count());
+        }
+
+        Frame& currentFrame(State& s) {
+            return s.frames[s.framesDone % FrameCapacity];
+        }
+
+        // Zone names are literals from our own code, but keep the JSON valid regardless
+        void writeJsonString(std::FILE* out, const char* text) {
+            std::fputc('"', out);
+            for (const char* c = text; *c; ++c) {
+                if (*c == '"' || *c == '\\') std::fputc('\\', out);
+                if (static_cast<unsigned char>(*c) >= 0x20) std::fputc(*c, out);
+            }
+            std::fputc('"', out);
+        }
+    }
+
+    void beginFrame() {
+        State& s = state();
+        profilerThread = true;
+
+        Frame& frame = currentFrame(s);
+        frame = Frame{};
+        frame.startNs = nowNs(s);
+        frame.firstZone = s.zonesUsed;
+        s.depth = 0;
+        s.inFrame = true;
+    }
+
+    void endFrame() {
+        State& s = state();
+        if (!s.inFrame || !profilerThread)
+            return;
+
+        Frame& frame = currentFrame(s);
+        frame.endNs = nowNs(s);
+        frame.zoneCount = static_cast<std::uint32_t>(s.zonesUsed - frame.firstZone);
+        s.framesDone++;
+        s.inFrame = false;
+    }
+
+    std::uint64_t beginZone(const char* name) {
+        if (!profilerThread)
+            return NoZone;
+        State& s = state();
+        if (!s.inFrame)
+            return NoZone;
+
+        std::uint64_t index = s.zonesUsed++;
+        s.zones[index % ZoneCapacity] = Zone{ name, nowNs(s), 0, s.depth++ };
+        return index;
+    }
+
+    void endZone(std::uint64_t zone) {
+        if (zone == NoZone)
+            return;
+        State& s = state();
+        s.zones[zone % ZoneCapacity].endNs = nowNs(s);
+        s.depth--;
+    }
+
+    void addCount(Counter counter, std::uint32_t amount) {
+        if (!profilerThread)
+            return;
+        State& s = state();
+        if (s.inFrame)
+            currentFrame(s).counters[static_cast<std::size_t>(counter)] += amount;
+    }
+
+    std::size_t getFrameCount() {
+        return static_cast<std::size_t>(std::min<std::uint64_t>(state().framesDone, FrameCapacity));
+    }
+
+    const Frame& getFrame(std::size_t age) {
+        State& s = state();
+        return s.frames[(s.framesDone - 1 - age) % FrameCapacity];
+    }
+
+    const Zone* getZone(std::uint64_t index) {
+        State& s = state();
+        if (index >= s.zonesUsed || s.zonesUsed - index > ZoneCapacity)
+            return nullptr;
+        return &s.zones[index % ZoneCapacity];
+    }
+
+    bool writeChromeTrace(const std::string& path, float seconds) {
+        std::FILE* out = std::fopen(path.c_str(), "w");
+        if (!out)
+            return false;
+
+        // Oldest frame first; timestamps are in microseconds
+        std::size_t frames = getFrameCount();
+        std::uint64_t cutoff = frames ? getFrame(0).endNs : 0;
+        cutoff = cutoff > static_cast<std::uint64_t>(seconds * 1e9f) ? cutoff - static_cast<std::uint64_t>(seconds * 1e9f) : 0;
+
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out);
+        std::fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}", out);
+
+        for (std::size_t age = frames; age-- > 0;) {
+            const Frame& frame = getFrame(age);
+            if (frame.startNs < cutoff)
+                continue;
+
+            std::fprintf(out, ",\n{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                frame.startNs / 1e3, (frame.endNs - frame.startNs) / 1e3);
+            for (std::uint64_t i = 0; i < frame.zoneCount; ++i) {
+                const Zone* zone = getZone(frame.firstZone + i);
+                if (!zone || zone->endNs < zone->startNs)
+                    continue;
+                std::fputs(",\n{\"name\":", out);
+                writeJsonString(out, zone->name);
+                std::fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                    zone->startNs / 1e3, (zone->endNs - zone->startNs) / 1e3);
+            }
+            std::fprintf(out, ",\n{\"name\":\"counts\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,"
+                "\"args\":{\"draw calls\":%u,\"entities\":%u,\"heap allocs\":%u}}",
+                frame.startNs / 1e3, frame.counter(Counter::DrawCalls), frame.counter(Counter::Entities),
+                frame.counter(Counter::HeapAllocs));
+        }
+
+        std::fputs("\n]}\n", out);
+        bool ok = std::ferror(out) == 0;
+        std::fclose(out);
+        return ok;
+    }
+}
+#endif
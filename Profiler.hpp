@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped frame profiler.
+// PROFILE_SCOPE("name") times the rest of the enclosing block and
+// PROFILE_COUNT(counter, n) adds to one of the frame's counters. Both only
+// record on the thread that calls beginFrame()/endFrame() (the main thread),
+// between those two calls. The last Constants::Profiler::FrameHistory frames
+// are kept in ring buffers, so recording never allocates.
+//
+// Build with PDR_PROFILE=0 to compile it out: the macros expand to nothing
+// and the Profiler functions are empty inlines.
+#ifndef PDR_PROFILE
+#define PDR_PROFILE 1
+#endif
+
+namespace Profiler {
+
+    enum class Counter : std::uint8_t {
+        DrawCalls,
+        Entities,
+        HeapAllocs, // operator new calls; only counted where the program replaces it (Main.cpp)
+        Count
+    };
+
+    struct Zone {
+        const char* name; // string literal
+        std::uint64_t startNs;
+        std::uint64_t endNs;
+        std::uint32_t depth; // 0 = directly inside the frame
+    };
+
+    struct Frame {
+        std::uint64_t startNs = 0;
+        std::uint64_t endNs = 0;
+        std::uint64_t firstZone = 0; // index for getZone()
+        std::uint32_t zoneCount = 0;
+        std::uint32_t counters[static_cast<std::size_t>(Counter::Count)] = {};
+
+        float millis() const { return (endNs - startNs) / 1e6f; }
+        std::uint32_t counter(Counter c) const { return counters[static_cast<std::size_t>(c)]; }
+    };
+
+    constexpr std::uint64_t NoZone = ~0ull;
+
+#if PDR_PROFILE
+    void beginFrame();
+    void endFrame();
+    std::uint64_t beginZone(const char* name);
+    void endZone(std::uint64_t zone);
+    void addCount(Counter counter, std::uint32_t amount);
+
+    // Finished frames still held; age 0 is the most recent one
+    std::size_t getFrameCount();
+    const Frame& getFrame(std::size_t age);
+    // Zones of old frames are overwritten first; nullptr once that happened
+    const Zone* getZone(std::uint64_t index);
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto) of the frames
+    // finished in the last `seconds`
+    bool writeChromeTrace(const std::string& path, float seconds);
+
+    class Scope {
+    public:
+        explicit Scope(const char* name) : zone(beginZone(name)) {}
+        ~Scope() { endZone(zone); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::uint64_t zone;
+    };
+#else
+    inline void beginFrame() {}
+    inline void endFrame() {}
+    inline std::size_t getFrameCount() { return 0; }
+    inline const Frame& getFrame(std::size_t) { static const Frame none; return none; }
+    inline const Zone* getZone(std::uint64_t) { return nullptr; }
+    inline bool writeChromeTrace(const std::string&, float) { return false; }
+#endif
+}
+
+#if PDR_PROFILE
+#define PDR_PROFILE_JOIN2(a, b) a##b
+#define PDR_PROFILE_JOIN(a, b) PDR_PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) ::Profiler::Scope PDR_PROFILE_JOIN(profileScope, __LINE__)(name)
+#define PROFILE_COUNT(counter, amount) ::Profiler::addCount(::Profiler::Counter::counter, static_cast<std::uint32_t>(amount))
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)0)
+#endif
@@ -0,0 +1,150 @@
+#include "ProfilerOverlay.hpp"
+#include "Constants.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const sf::Color Palette[] = {
+        { 230, 25, 75 }, { 60, 180, 75 }, { 255, 225, 25 }, { 0, 130, 200 },
+        { 245, 130, 48 }, { 145, 30, 180 }, { 70, 240, 240 }, { 240, 50, 230 },
+        { 210, 245, 60 }, { 250, 190, 212 }, { 0, 128, 128 }, { 220, 190, 255 },
+        { 170, 110, 40 }, { 255, 250, 200 }, { 128, 0, 0 }, { 170, 255, 195 },
+        { 200, 200, 200 }
+    };
+
+    void appendRect(sf::VertexArray& va, sf::Vector2f pos, sf::Vector2f size, sf::Color color) {
+        sf::Vector2f b{ pos.x + size.x, pos.y };
+        sf::Vector2f c{ pos.x + size.x, pos.y + size.y };
+        sf::Vector2f d{ pos.x, pos.y + size.y };
+        va.append({ pos, color }); va.append({ b, color }); va.append({ c, color });
+        va.append({ pos, color }); va.append({ c, color }); va.append({ d, color });
+    }
+}
+
+ProfilerOverlay::ProfilerOverlay(const sf::Font& font) : text(font) {
+    statsLabel = text.addLabel(14, sf::Color::White);
+    for (std::size_t i = 0; i < MaxSeries; ++i)
+        freeLabels.push_back(text.addLabel(12, Palette[i]));
+    std::reverse(freeLabels.begin(), freeLabels.end());
+    series.reserve(MaxSeries);
+    frameMs.resize(MaxSeries);
+}
+
+std::size_t ProfilerOverlay::seriesFor(const char* name) {
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        if (series[i].name == name || std::strcmp(series[i].name, name) == 0)
+            return i;
+    }
+    if (series.size() + 1 == MaxSeries) {
+        series.push_back({ "other", Palette[MaxSeries - 1], 0.0, freeLabels.back() });
+        freeLabels.pop_back();
+    }
+    if (series.size() == MaxSeries)
+        return MaxSeries - 1;
+
+    series.push_back({ name, Palette[series.size()], 0.0, freeLabels.back() });
+    freeLabels.pop_back();
+    return series.size() - 1;
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target) {
+    PROFILE_SCOPE("ProfilerOverlay::draw");
+
+    const std::size_t frames = std::min(Profiler::getFrameCount(), Constants::Profiler::OverlayFrames);
+    const float panelWidth = Constants::Profiler::OverlayFrames * BarWidth;
+    const float scale = PanelHeight / MsPerPanel;
+    sf::Vector2f win(target.getSize());
+    sf::Vector2f topLeft{ win.x - panelWidth - 10.f, win.y - PanelHeight - 10.f };
+    float bottom = topLeft.y + PanelHeight;
+
+    bars.clear();
+    appendRect(bars, topLeft, { panelWidth, PanelHeight }, sf::Color(0, 0, 0, 170));
+
+    for (Series& s : series)
+        s.totalMs = 0.0;
+
+    // Newest frame on the right
+    for (std::size_t age = 0; age < frames; ++age) {
+        const Profiler::Frame& frame = Profiler::getFrame(age);
+        float x = topLeft.x + panelWidth - (age + 1) * BarWidth;
+
+        // Own time per zone: a zone's children follow it with a greater depth
+        std::fill(frameMs.begin(), frameMs.end(), 0.f);
+        openZones.clear();
+        auto close = [&]() {
+            const OpenZone& z = openZones.back();
+            frameMs[z.series] += static_cast<float>(std::max(0.0, z.ms - z.childMs));
+            openZones.pop_back();
+        };
+        for (std::uint32_t i = 0; i < frame.zoneCount; ++i) {
+            const Profiler::Zone* zone = Profiler::getZone(frame.firstZone + i);
+            if (!zone) continue;
+            while (!openZones.empty() && openZones.back().depth >= zone->depth)
+                close();
+            double ms = (zone->endNs - zone->startNs) / 1e6;
+            if (!openZones.empty())
+                openZones.back().childMs += ms;
+            openZones.push_back({ seriesFor(zone->name), ms, 0.0, zone->depth });
+        }
+        while (!openZones.empty())
+            close();
+
+        float total = std::min(frame.millis() * scale, PanelHeight);
+        appendRect(bars, { x, bottom - total }, { BarWidth, total }, sf::Color(90, 90, 90));
+
+        float y = bottom;
+        for (std::size_t s = 0; s < series.size(); ++s) {
+            series[s].totalMs += frameMs[s];
+            float h = std::min(frameMs[s] * scale, y - topLeft.y);
+            if (h <= 0.f) continue;
+            y -= h;
+            appendRect(bars, { x, y }, { BarWidth, h }, series[s].color);
+        }
+    }
+
+    for (float ms : { 1000.f / 60.f, 1000.f / 30.f })
+        appendRect(bars, { topLeft.x, bottom - ms * scale }, { panelWidth, 1.f }, sf::Color(255, 255, 255, 120));
+
+    target.draw(bars);
+    PROFILE_COUNT(DrawCalls, 1);
+
+    if (framesUntilText-- <= 0) {
+        updateText(frames, topLeft);
+        framesUntilText = TextInterval;
+    }
+    text.draw(target);
+}
+
+void ProfilerOverlay::updateText(std::size_t frames, sf::Vector2f panelTopLeft) {
+    char line[160];
+    if (frames == 0) {
+        text.setString(statsLabel, "profiler: no frames yet");
+    }
+    else {
+        const Profiler::Frame& last = Profiler::getFrame(0);
+        float worst = 0.f;
+        double sum = 0.0;
+        for (std::size_t age = 0; age < frames; ++age) {
+            float ms = Profiler::getFrame(age).millis();
+            worst = std::max(worst, ms);
+            sum += ms;
+        }
+        std::snprintf(line, sizeof(line), "frame %.2f ms avg, %.2f ms worst | draw calls %u | entities %u | heap allocs %u",
+            sum / frames, worst, last.counter(Profiler::Counter::DrawCalls), last.counter(Profiler::Counter::Entities),
+            last.counter(Profiler::Counter::HeapAllocs));
+        text.setString(statsLabel, line);
+    }
+
+    // Legend in three columns above the panel
+    const float columnWidth = Constants::Profiler::OverlayFrames * BarWidth / 3.f;
+    const std::size_t rows = (series.size() + 2) / 3;
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        std::snprintf(line, sizeof(line), "%s %.2f", series[i].name, frames ? series[i].totalMs / frames : 0.0);
+        text.setString(series[i].label, line);
+        text.setPosition(series[i].label, { panelTopLeft.x + (i / rows) * columnWidth,
+            panelTopLeft.y - (rows - i % rows) * 15.f - 4.f });
+    }
+    text.setPosition(statsLabel, { panelTopLeft.x, panelTopLeft.y - rows * 15.f - 24.f });
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "HudText.hpp"
+
+// On-screen view of the Profiler: one bar per recent frame, stacked by each
+// zone's own time (its children not included) and grey for whatever no
+// marker covered, with 16.7 / 33.3 ms guides. Above it, the average per
+// zone and the last frame's draw-call and entity counts.
+class ProfilerOverlay {
+public:
+    explicit ProfilerOverlay(const sf::Font& font);
+
+    void draw(sf::RenderTarget& target);
+
+private:
+    struct Series {
+        const char* name;
+        sf::Color color;
+        double totalMs = 0.0; // over the frames on screen
+        HudText::LabelId label;
+    };
+
+    struct OpenZone {
+        std::size_t series;
+        double ms;
+        double childMs;
+        std::uint32_t depth;
+    };
+
+    static constexpr std::size_t MaxSeries = 17; // the last one collects the rest
+    static constexpr float BarWidth = 2.f;
+    static constexpr float PanelHeight = 120.f;
+    static constexpr float MsPerPanel = 40.f;
+    static constexpr int TextInterval = 30; // frames between legend refreshes
+
+    HudText text;
+    HudText::LabelId statsLabel;
+    std::vector<Series> series;
+    std::vector<HudText::LabelId> freeLabels;
+    std::vector<float> frameMs;                           // per series, one frame
+    std::vector<OpenZone> openZones;
+    sf::VertexArray bars{ sf::PrimitiveType::Triangles };
+    int framesUntilText = 0;
+
+    std::size_t seriesFor(const char* name);
+    void updateText(std::size_t frames, sf::Vector2f panelTopLeft);
+};
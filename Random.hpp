@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+// Independent random streams fanned out from one run seed.
+enum class RngStreamId : std::uint64_t {
+    Generation = 1,
+    Spawning,
+    Loot,
+    Combat
+};
+
+// Counter-based generator: value n of a stream is a pure function of
+// (key, n), so streams are free to create, never correlate and can be
+// saved/restored as two integers.
+//
+// The helpers below are used instead of std:: distributions because those
+// differ between standard libraries, which would break reproducibility.
+class RandomStream {
+public:
+    using result_type = std::uint64_t;
+
+    RandomStream() = default;
+    explicit RandomStream(std::uint64_t key, std::uint64_t counter = 0)
+        : key(key), counter(counter) {}
+
+    // Key for stream `id` of a run, optionally specialised further (floor number...)
+    static std::uint64_t deriveKey(std::uint64_t seed, RngStreamId id, std::uint64_t salt = 0) {
+        return mix(mix(seed ^ mix(static_cast<std::uint64_t>(id))) + salt * Gamma);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return mix(key + (++counter) * Gamma); }
+
+    // Uniform integer in [lo, hi]
+    int uniformInt(int lo, int hi) {
+        if (hi <= lo) return lo;
+        std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(hi) - lo) + 1;
+        return lo + static_cast<int>(bounded(range));
+    }
+
+    std::size_t uniformIndex(std::size_t count) {
+        return count == 0 ? 0 : static_cast<std::size_t>(bounded(count));
+    }
+
+    // Uniform float in [lo, hi)
+    float uniformFloat(float lo, float hi) {
+        float unit = static_cast<float>((*this)() >> 40) * (1.f / 16777216.f); // 24 bits
+        return lo + (hi - lo) * unit;
+    }
+
+    template <typename It>
+    void shuffle(It first, It last) {
+        auto n = std::distance(first, last);
+        for (auto i = n - 1; i > 0; --i) {
+            auto j = static_cast<decltype(i)>(bounded(static_cast<std::uint64_t>(i) + 1));
+            using std::swap;
+            swap(first[i], first[j]);
+        }
+    }
+
+    std::uint64_t getKey() const { return key; }
+    std::uint64_t getCounter() const { return counter; }
+
+private:
+    static constexpr std::uint64_t Gamma = 0x9E3779B97F4A7C15ull;
+
+    std::uint64_t key = 0;
+    std::uint64_t counter = 0;
+
+    // SplitMix64 finalizer
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Unbiased value in [0, range) (rejection on the low end)
+    std::uint64_t bounded(std::uint64_t range) {
+        std::uint64_t threshold = (0 - range) % range;
+        while (true) {
+            std::uint64_t r = (*this)();
+            if (r >= threshold)
+                return r % range;
+        }
+    }
+};
@@ -0,0 +1,137 @@
+#include "Replay.hpp"
+#include "Simulation.hpp"
+#include <fstream>
+
+namespace {
+    constexpr std::uint32_t Magic = 0x52524450; // "PDRR"
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t seed;
+        sf::Vector2i floorSize;
+        Replay::Outcome outcome;
+    };
+
+    struct InputRun {
+        std::uint32_t ticks;
+        std::uint16_t bits;
+        std::uint8_t padding[2] = {};
+    };
+
+    enum InputBit : std::uint16_t {
+        Up = 1 << 0,
+        Down = 1 << 1,
+        Left = 1 << 2,
+        Right = 1 << 3,
+        Attack = 1 << 4,
+        AdvanceFloor = 1 << 5,
+        Restart = 1 << 6,
+        SpeedUp = 1 << 7,
+        SpeedDown = 1 << 8
+    };
+}
+
+void Replay::begin(const Simulation& sim, bool withSnapshot) {
+    seed = sim.getSeed();
+    floorSize = sim.getFloorSize();
+    inputs.clear();
+    reserveAhead();
+    snapshot.clear();
+    if (withSnapshot) {
+        SnapshotWriter writer(snapshot);
+        sim.writeSnapshot(writer);
+    }
+    outcome = outcomeOf(sim);
+}
+
+void Replay::reserveAhead() {
+    // Twice the margin, so this reallocates at most once per ReserveTicks
+    if (inputs.capacity() - inputs.size() < ReserveTicks)
+        inputs.reserve(inputs.size() + 2 * ReserveTicks);
+}
+
+bool Replay::save(const std::string& path) const {
+    std::vector<InputRun> runs;
+    for (std::uint16_t bits : inputs) {
+        if (runs.empty() || runs.back().bits != bits)
+            runs.push_back({ 0, bits });
+        runs.back().ticks++;
+    }
+
+    std::vector<std::uint8_t> buffer;
+    SnapshotWriter writer(buffer);
+    writer.write(FileHeader{ Magic, FormatVersion, seed, floorSize, outcome });
+    writer.writeArray(snapshot);
+    writer.writeArray(runs);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return file.good();
+}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    std::vector<std::uint8_t> buffer(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size())))
+        return false;
+
+    SnapshotReader reader(buffer.data(), buffer.size());
+    FileHeader header;
+    std::vector<InputRun> runs;
+    if (!reader.read(header) || header.magic != Magic || header.version != FormatVersion ||
+        !reader.readArray(snapshot) || !reader.readArray(runs) || !reader.atEnd())
+        return false;
+
+    seed = header.seed;
+    floorSize = header.floorSize;
+    outcome = header.outcome;
+    inputs.clear();
+    for (const InputRun& run : runs)
+        inputs.insert(inputs.end(), run.ticks, run.bits);
+    return true;
+}
+
+bool Replay::applyStart(Simulation& sim) const {
+    if (snapshot.empty())
+        return true;
+    SnapshotReader reader(snapshot.data(), snapshot.size());
+    return sim.readSnapshot(reader);
+}
+
+Replay::Outcome Replay::outcomeOf(const Simulation& sim) {
+    Outcome o;
+    o.tick = sim.getTick();
+    o.floorNumber = sim.getFloorNumber();
+    o.enemiesDefeated = sim.getEnemiesDefeated();
+    o.enemies = static_cast<std::uint32_t>(sim.getEnemies().size());
+    o.health = sim.getPlayer().getHealth();
+    o.playerPosition = sim.getPlayer().getPosition();
+    return o;
+}
+
+std::uint16_t Replay::pack(const SimInput& input) {
+    return static_cast<std::uint16_t>((input.up ? Up : 0) | (input.down ? Down : 0) | (input.left ? Left : 0) |
+        (input.right ? Right : 0) | (input.attack ? Attack : 0) |
+        (input.advanceFloor ? AdvanceFloor : 0) | (input.restart ? Restart : 0) |
+        (input.speedUp ? SpeedUp : 0) | (input.speedDown ? SpeedDown : 0));
+}
+
+SimInput Replay::unpack(std::uint16_t bits) {
+    SimInput input;
+    input.up = bits & Up;
+    input.down = bits & Down;
+    input.left = bits & Left;
+    input.right = bits & Right;
+    input.attack = bits & Attack;
+    input.advanceFloor = bits & AdvanceFloor;
+    input.restart = bits & Restart;
+    input.speedUp = bits & SpeedUp;
+    input.speedDown = bits & SpeedDown;
+    return input;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Constants.hpp"
+#include "SimInput.hpp"
+
+class Simulation;
+
+// A recorded session: where the simulation started and the SimInput of every
+// tick since. Simulation::step is deterministic for a given start state and
+// input sequence, so stepping a fresh Simulation through the same inputs
+// reproduces the session exactly, deaths, floors and all.
+//
+// A recording normally starts from a freshly constructed Simulation and only
+// needs its seed and floor size. One started later (e.g. right after a
+// quick-load) carries a snapshot of the start state instead.
+//
+// File: header, start snapshot (may be empty), then the inputs run-length
+// encoded as (input bits, tick count) pairs.
+class Replay {
+public:
+    static constexpr std::uint32_t FormatVersion = 4; // 4: 16-bit inputs with the debug speed keys
+    static constexpr std::size_t ReserveTicks = Constants::Sim::TickRate * 60 * 10; // ten minutes, 72 KB
+
+    // State after the last recorded tick, to check a playback ended up in
+    // the same place
+    struct Outcome {
+        std::uint64_t tick = 0;
+        std::int32_t floorNumber = 0;
+        std::int32_t enemiesDefeated = 0;
+        std::uint32_t enemies = 0;
+        float health = 0.f;
+        sf::Vector2f playerPosition;
+
+        bool operator==(const Outcome&) const = default;
+    };
+
+    // Start recording from sim's current state. withSnapshot = false is
+    // only right for a Simulation fresh out of its constructor.
+    void begin(const Simulation& sim, bool withSnapshot);
+    // Keeps at least ReserveTicks of room after the last input, so record()
+    // only allocates when a stretch of play outlasts it. begin() calls it;
+    // call it again wherever an allocation is already expected (a new floor).
+    void reserveAhead();
+    void record(const SimInput& input) { inputs.push_back(pack(input)); }
+    void finish(const Simulation& sim) { outcome = outcomeOf(sim); }
+
+    bool save(const std::string& path = "replay.bin") const;
+    bool load(const std::string& path = "replay.bin");
+
+    // Loads the start snapshot, if there is one, into a Simulation built
+    // with getSeed() and getFloorSize()
+    bool applyStart(Simulation& sim) const;
+    SimInput inputAt(std::size_t tick) const { return unpack(inputs[tick]); }
+
+    std::uint64_t getSeed() const { return seed; }
+    sf::Vector2i getFloorSize() const { return floorSize; }
+    std::size_t getTickCount() const { return inputs.size(); }
+    bool hasSnapshot() const { return !snapshot.empty(); }
+    const Outcome& getOutcome() const { return outcome; }
+
+    static Outcome outcomeOf(const Simulation& sim);
+    static std::uint16_t pack(const SimInput& input);
+    static SimInput unpack(std::uint16_t bits);
+
+private:
+    std::uint64_t seed = 0;
+    sf::Vector2i floorSize;
+    std::vector<std::uint8_t> snapshot;
+    std::vector<std::uint16_t> inputs; // pack()ed, one per tick
+    Outcome outcome;
+};
@@ -0,0 +1,111 @@
+#include "RunHistory.hpp"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    constexpr std::uint32_t Magic = 0x48524450; // "PDRH"
+    constexpr std::size_t ChunkRecords = 4096;
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t recordSize;
+    };
+
+    bool headerMatches(const FileHeader& header) {
+        return header.magic == Magic && header.version == RunHistory::FormatVersion &&
+            header.recordSize == sizeof(RunSummary);
+    }
+
+    // Opens for appending, writing the header into a new file and checking
+    // the one already there otherwise
+    bool openForAppend(std::fstream& file, const std::string& path) {
+        file.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+        if (!file.is_open()) {
+            file.clear();
+            file.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+        }
+
+        if (file.tellp() == std::streampos(0)) {
+            FileHeader header{ Magic, RunHistory::FormatVersion, sizeof(RunSummary) };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            return file.good();
+        }
+
+        // Appending to a file cut off mid-record would misalign everything after it
+        std::streamoff size = file.tellp();
+        FileHeader header{};
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !headerMatches(header) ||
+            (size - static_cast<std::streamoff>(sizeof(header))) % sizeof(RunSummary) != 0)
+            return false;
+        file.seekp(0, std::ios::end);
+        return file.good();
+    }
+}
+
+namespace RunHistory {
+
+    bool append(const RunSummary& run, const std::string& path) {
+        std::fstream file;
+        if (!openForAppend(file, path))
+            return false;
+        file.write(reinterpret_cast<const char*>(&run), sizeof(run));
+        return file.good();
+    }
+
+    int importText(const std::string& textPath, const std::string& path) {
+        std::ifstream text(textPath);
+        std::fstream file;
+        if (!text.is_open() || !openForAppend(file, path))
+            return -1;
+
+        std::vector<RunSummary> runs;
+        std::string line;
+        while (std::getline(text, line)) {
+            int floor = 0;
+            int kills = 0;
+            if (std::sscanf(line.c_str(), " Floor: %d | Enemies: %d", &floor, &kills) != 2)
+                continue;
+
+            RunSummary run;
+            run.floorsReached = static_cast<std::uint16_t>(std::clamp(floor, 0, 0xFFFF));
+            run.totalKills = static_cast<std::uint32_t>(std::max(kills, 0));
+            run.flags = RunSummary::Imported;
+            runs.push_back(run);
+        }
+
+        file.write(reinterpret_cast<const char*>(runs.data()),
+            static_cast<std::streamsize>(runs.size() * sizeof(RunSummary)));
+        return file.good() ? static_cast<int>(runs.size()) : -1;
+    }
+
+    bool Reader::open(const std::string& path) {
+        file.open(path, std::ios::binary);
+        FileHeader header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !headerMatches(header))
+            return false;
+
+        chunk.resize(ChunkRecords);
+        chunk.clear();
+        chunkPos = 0;
+        return true;
+    }
+
+    bool Reader::next(RunSummary& out) {
+        if (chunkPos == chunk.size()) {
+            // A trailing partial record is ignored
+            chunk.resize(ChunkRecords);
+            file.read(reinterpret_cast<char*>(chunk.data()),
+                static_cast<std::streamsize>(ChunkRecords * sizeof(RunSummary)));
+            chunk.resize(static_cast<std::size_t>(file.gcount()) / sizeof(RunSummary));
+            chunkPos = 0;
+            if (chunk.empty())
+                return false;
+        }
+        out = chunk[chunkPos++];
+        return true;
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Loot.hpp"
+
+// One finished run, as stored in the run history.
+struct RunSummary {
+    enum Flags : std::uint8_t {
+        Imported = 1 // from the old runs.txt: only floors and total kills are known
+    };
+
+    std::uint64_t seed = 0;
+    std::int64_t endedAt = 0; // unix time, 0 if unknown
+    float runSeconds = 0.f;
+    float frameP50Ms = 0.f;
+    float frameP99Ms = 0.f;
+    std::uint32_t totalKills = 0;
+    std::uint32_t killsByRarity[EnemyRarityCount] = {};
+    std::uint16_t floorsReached = 0;
+    std::uint16_t peakEnemies = 0;
+    std::uint8_t killedBy = 0; // EnemyRarity + 1, 0 if unknown
+    std::uint8_t flags = 0;
+    std::uint8_t padding[6] = {};
+};
+static_assert(sizeof(RunSummary) == 56, "run summaries are written raw");
+
+// Equal-width buckets starting at 0; values past the end land in the last
+// bucket. Only the constructor allocates, so add() is safe every frame.
+class Histogram {
+public:
+    Histogram(double bucketWidth, std::size_t bucketCount)
+        : width(bucketWidth), buckets(bucketCount, 0) {}
+
+    void add(double value) {
+        std::size_t i = value <= 0.0 ? 0 : static_cast<std::size_t>(value / width);
+        buckets[std::min(i, buckets.size() - 1)]++;
+        total++;
+        sum += value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    void clear() {
+        std::fill(buckets.begin(), buckets.end(), 0);
+        total = 0;
+        sum = 0.0;
+        minValue = 1e300;
+        maxValue = -1e300;
+    }
+
+    std::uint64_t count() const { return total; }
+    double mean() const { return total ? sum / total : 0.0; }
+    double min() const { return total ? minValue : 0.0; }
+    double max() const { return total ? maxValue : 0.0; }
+    double bucketWidth() const { return width; }
+    const std::vector<std::uint64_t>& getBuckets() const { return buckets; }
+
+    // Lower edge of the bucket holding the p-th value (p in 0..1), so exact
+    // for whole numbers in buckets of width 1
+    double percentile(double p) const {
+        if (total == 0) return 0.0;
+        std::uint64_t rank = static_cast<std::uint64_t>(p * (total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank)
+                return std::clamp(i * width, minValue, maxValue);
+        }
+        return maxValue;
+    }
+
+private:
+    double width;
+    std::vector<std::uint64_t> buckets;
+    std::uint64_t total = 0;
+    double sum = 0.0;
+    double minValue = 1e300;
+    double maxValue = -1e300;
+};
+
+// Append-only run history file: "PDRH", format version (u32), record size
+// (u32), then RunSummary records. A file written with another version or
+// record size is never appended to or read.
+namespace RunHistory {
+    constexpr std::uint32_t FormatVersion = 1;
+    constexpr const char* DefaultPath = "runs.bin";
+
+    bool append(const RunSummary& run, const std::string& path = DefaultPath);
+
+    // Converts "Floor: N | Enemies: M" lines and appends them as Imported
+    // records. Returns how many were imported, or -1 if either file
+    // couldn't be used.
+    int importText(const std::string& textPath, const std::string& path = DefaultPath);
+
+    // Streams a history file in fixed-size chunks, so memory use doesn't
+    // depend on how many runs it holds.
+    class Reader {
+    public:
+        bool open(const std::string& path = DefaultPath);
+        bool next(RunSummary& out);
+
+    private:
+        std::ifstream file;
+        std::vector<RunSummary> chunk;
+        std::size_t chunkPos = 0;
+    };
+}
@@ -0,0 +1,91 @@
+#include "SaveSystem.hpp"
+#include "Simulation.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr std::uint32_t Magic = 0x53524450; // "PDRS"
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t payloadSize;
+        std::uint64_t checksum;
+    };
+
+    // FNV-1a over 8-byte words (tail bytes zero-padded): cheap enough to
+    // run on every load and catches truncated or damaged files
+    std::uint64_t checksum(const std::uint8_t* data, std::size_t size) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * 0x100000001B3ull;
+        }
+        if (i < size) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, data + i, size - i);
+            hash = (hash ^ word) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    float millisSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+bool SaveSystem::quickSave(const Simulation& sim, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Header space first, filled in once the payload size is known
+    buffer.assign(sizeof(FileHeader), 0);
+    SnapshotWriter writer(buffer);
+    sim.writeSnapshot(writer);
+
+    const std::uint8_t* payload = buffer.data() + sizeof(FileHeader);
+    std::size_t payloadSize = buffer.size() - sizeof(FileHeader);
+    FileHeader header{ Magic, FormatVersion, payloadSize, checksum(payload, payloadSize) };
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    bool written = file.good();
+
+    lastSaveMillis = millisSince(start);
+    return written;
+}
+
+bool SaveSystem::quickLoad(Simulation& sim, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    std::streamoff size = file.tellg();
+    if (size < static_cast<std::streamoff>(sizeof(FileHeader)))
+        return false;
+
+    buffer.resize(static_cast<std::size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), size))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    const std::uint8_t* payload = buffer.data() + sizeof(FileHeader);
+    std::size_t payloadSize = buffer.size() - sizeof(FileHeader);
+    if (header.magic != Magic || header.version != FormatVersion ||
+        header.payloadSize != payloadSize || header.checksum != checksum(payload, payloadSize))
+        return false;
+
+    SnapshotReader reader(payload, payloadSize);
+    bool loaded = sim.readSnapshot(reader);
+
+    lastLoadMillis = millisSince(start);
+    return loaded;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Simulation;
+
+// Quick-save files: a fixed header (magic, format version, payload size and
+// checksum) followed by Simulation::writeSnapshot's bytes. Saving is one
+// write; loading is one read of the whole file and a checksum pass before
+// the simulation is touched. Bump FormatVersion whenever a saved record or
+// the order of things in a snapshot changes; older files are refused.
+class SaveSystem {
+public:
+    static constexpr std::uint32_t FormatVersion = 4;
+
+    bool quickSave(const Simulation& sim, const std::string& path = "quicksave.bin");
+    bool quickLoad(Simulation& sim, const std::string& path = "quicksave.bin");
+
+    // Wall time of the last save/load, file I/O included
+    float getLastSaveMillis() const { return lastSaveMillis; }
+    float getLastLoadMillis() const { return lastLoadMillis; }
+    std::size_t getLastSize() const { return buffer.size(); }
+
+private:
+    std::vector<std::uint8_t> buffer; // reused, so saving doesn't reallocate
+    float lastSaveMillis = 0.f;
+    float lastLoadMillis = 0.f;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+// Player intent for one simulation tick.
+// The SFML front end fills this from the keyboard; headless tools fill it themselves.
+struct SimInput {
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+
+    // Debug: player speed +/- 2 every tick while held, down to 1
+    bool speedUp = false;       // Y
+    bool speedDown = false;     // X
+
+    // One-shot actions (key presses, not held keys)
+    bool attack = false;        // F
+    bool advanceFloor = false;  // T
+    bool restart = false;       // R
+};
@@ -0,0 +1,739 @@
+#include "Simulation.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // Plain records for the parts of a snapshot that hold SFML objects. They
+    // are written as raw bytes, so every gap the compiler would leave is an
+    // explicit, zeroed padding field and saves of the same state match.
+
+    struct RunRecord {
+        std::uint64_t seed;
+        std::uint64_t tick;
+        Simulation::GameState state;
+        bool bossAlive;
+        bool bossSpawned;
+        bool runEnded;
+        bool attackReady;
+        int enemiesDefeated;
+        int floorNumber;
+        int enemiesKilledThisFloor;
+        int enemiesToClear;
+        int enemiesToClearThisFloor;
+        int enemiesToSpawn;
+        sf::Vector2i floorSize;
+        float pickupRadius;
+        EnemyHandle bossHandle;
+        std::uint32_t padding = 0;
+        RandomStream spawnRng;
+        RandomStream lootRng;
+        RandomStream combatRng;
+        RunStats stats;
+    };
+
+    struct PlayerRecord {
+        Entity::SavedState entity;
+        bool hasDamageBoost;
+        bool hasSpeedBoost;
+        std::uint8_t padding[2] = {};
+        TimedBoost damageBoost;
+        TimedBoost speedBoost;
+    };
+
+    struct EnemyRecord {
+        Entity::SavedState entity;
+        Enemy::AttackState attackState;
+        bool windupComplete;
+        std::uint8_t padding[3] = {};
+        TimerId attackTimer;
+        EnemyRarity rarity;
+    };
+
+    struct PickupRecord {
+        sf::Vector2f position;
+        Pickup::Type type;
+        float value;
+        float duration;
+    };
+}
+
+Simulation::Simulation(std::uint64_t seed, sf::Vector2i floorSize)
+    : dungeon(),
+    player(dungeon),
+    loot(lootRng),
+    floorSize(floorSize)
+{
+    enemyDropTable = {
+    { Pickup::Type::Heal,        60.f, 20.f, 0.f },
+    { Pickup::Type::DamageBoost, 25.f, 0.3f, 6.f },
+    { Pickup::Type::SpeedBoost,  15.f, 0.25f, 6.f }
+    };
+
+    restart(seed);
+}
+
+void Simulation::step(const SimInput& input, float dt)
+{
+    PROFILE_SCOPE("Simulation::step");
+    events.clear();
+    scratch.reset();
+    tick++;
+
+    // --- ONE-SHOT ACTIONS ---
+    if (input.restart && state == GameState::Dead)
+        restart(RandomStream(seed, tick)()); // next run seed follows from this one
+
+    if (state == GameState::Playing)
+        timers.advance(tick, [this](const SimTimer& timer) { onTimer(timer); });
+
+    if (input.attack && state == GameState::Playing && canAttack())
+        handlePlayerAttack();
+
+    if (input.advanceFloor && state == GameState::Playing && canAdvanceFloor())
+        advanceFloor();
+
+    if (state == GameState::Dead) return; // Pause game updates
+
+    if (input.speedUp) player.setSpeed(player.getSpeed() + 2.f);
+    if (input.speedDown) player.setSpeed(std::max(1.f, player.getSpeed() - 2.f));
+
+    player.handleInput(input, spatial, dt);
+    player.avoidEnemies(spatial); // pushing
+    spatial.update(player.spatialProxy, player.getBounds());
+
+    sf::Vector2f pos = player.getPosition();
+    int tileX = std::clamp(static_cast<int>(pos.x / TILE_SIZE), 0, dungeon.getWidth() - 1);
+    int tileY = std::clamp(static_cast<int>(pos.y / TILE_SIZE), 0, dungeon.getHeight() - 1);
+
+    // Keep the map around the player decoded before anything reads it
+    dungeon.setFocus(tileX, tileY);
+
+    if (dungeon.markVisible(tileX, tileY, VisionRadiusTiles))
+        events.revealedTiles = true;
+
+    // Enemies path towards the player's centre tile; only rebuilt when it changes
+    sf::Vector2f center = player.getCenter();
+    pursuit.update(dungeon.getMap(),
+        std::clamp(static_cast<int>(center.x / TILE_SIZE), 0, dungeon.getWidth() - 1),
+        std::clamp(static_cast<int>(center.y / TILE_SIZE), 0, dungeon.getHeight() - 1),
+        dungeon.getActiveRegion());
+
+    handleEnemyAttacks(dt);
+    collectPickups();
+    runStats.peakEnemies = std::max(runStats.peakEnemies, static_cast<std::uint32_t>(enemies.size()));
+
+    if (player.getHealth() <= 0 && !runEnded) {
+        runEnded = true;
+        endRun();
+    }
+
+    if (player.isDead()) {
+        state = GameState::Dead;
+        return;
+    }
+}
+
+void Simulation::onTimer(const SimTimer& timer)
+{
+    switch (timer.kind) {
+    case SimTimer::Kind::PlayerAttackReady:
+        attackReady = true;
+        break;
+
+    case SimTimer::Kind::PlayerFlashEnd:
+        player.clearDamageFlash();
+        break;
+
+    case SimTimer::Kind::DamageBoostEnd:
+        player.damageBoost.reset();
+        break;
+
+    case SimTimer::Kind::SpeedBoostEnd:
+        player.speedBoost.reset();
+        player.setSpeed(140.f);
+        break;
+
+    case SimTimer::Kind::EnemyWindupDone:
+        if (Enemy* enemy = enemies.get(timer.enemy))
+            enemy->windupComplete = true;
+        break;
+
+    case SimTimer::Kind::EnemyCooldownOver:
+        if (Enemy* enemy = enemies.get(timer.enemy))
+            enemy->finishCooldown();
+        break;
+
+    case SimTimer::Kind::EnemyFlashEnd:
+        if (Enemy* enemy = enemies.get(timer.enemy))
+            enemy->clearDamageFlash();
+        break;
+    }
+}
+
+void Simulation::startDamageFlash(Entity& target, const SimTimer& end)
+{
+    // A new hit restarts the flash
+    timers.cancel(target.flashTimer);
+    target.flashTimer = timers.scheduleIn(DamageFlashTicks, end);
+}
+
+void Simulation::restart(std::uint64_t newSeed)
+{
+    seed = newSeed;
+    lootRng = RandomStream(RandomStream::deriveKey(seed, RngStreamId::Loot));
+    combatRng = RandomStream(RandomStream::deriveKey(seed, RngStreamId::Combat));
+
+    // Timers from the last run are meaningless now
+    timers.reset(tick);
+    player.damageBoost.reset();
+    player.speedBoost.reset();
+    player.setSpeed(140.f);
+    player.clearDamageFlash();
+
+    player.setHealth(100.f);
+    state = GameState::Playing;
+    enemiesDefeated = 0;
+    runStats = RunStats{};
+    runStats.startTick = tick;
+    bossAlive = true;
+    runEnded = false;
+    bossSpawned = false;
+    attackReady = false;
+    timers.scheduleIn(AttackCooldownTicks, { SimTimer::Kind::PlayerAttackReady });
+    floorNumber = 1;
+    enemiesToSpawn = 6;
+    startFloor();
+}
+
+void Simulation::writeSnapshot(SnapshotWriter& out) const {
+    out.write(RunRecord{ .seed = seed, .tick = tick, .state = state, .bossAlive = bossAlive,
+        .bossSpawned = bossSpawned, .runEnded = runEnded, .attackReady = attackReady,
+        .enemiesDefeated = enemiesDefeated, .floorNumber = floorNumber,
+        .enemiesKilledThisFloor = enemiesKilledThisFloor, .enemiesToClear = enemiesToClear,
+        .enemiesToClearThisFloor = enemiesToClearThisFloor, .enemiesToSpawn = enemiesToSpawn,
+        .floorSize = floorSize, .pickupRadius = pickupRadius, .bossHandle = bossHandle,
+        .spawnRng = spawnRng, .lootRng = lootRng, .combatRng = combatRng, .stats = runStats });
+
+    dungeon.writeSnapshot(out);
+    timers.writeSnapshot(out);
+
+    out.write(PlayerRecord{ .entity = player.saveState(),
+        .hasDamageBoost = player.damageBoost.has_value(), .hasSpeedBoost = player.speedBoost.has_value(),
+        .damageBoost = player.damageBoost.value_or(TimedBoost{}),
+        .speedBoost = player.speedBoost.value_or(TimedBoost{}) });
+
+    std::vector<EnemyRecord> enemyRecords;
+    enemyRecords.reserve(enemies.size());
+    for (const Enemy& e : enemies)
+        enemyRecords.push_back({ .entity = e.saveState(), .attackState = e.attackState,
+            .windupComplete = e.windupComplete, .attackTimer = e.attackTimer, .rarity = e.rarity });
+    out.writeArray(enemyRecords);
+    enemies.writeSnapshot(out);
+
+    std::vector<PickupRecord> pickupRecords;
+    pickupRecords.reserve(pickups.size());
+    for (const Pickup& p : pickups)
+        pickupRecords.push_back({ p.position, p.type, p.value, p.duration });
+    out.writeArray(pickupRecords);
+}
+
+bool Simulation::readSnapshot(SnapshotReader& in) {
+    RunRecord run;
+    PlayerRecord saved;
+    std::vector<EnemyRecord> enemyRecords;
+    std::vector<PickupRecord> pickupRecords;
+
+    // Everything is read into spares first and only taken once the whole
+    // snapshot has checked out, so a refused load leaves the run as it was
+    Dungeon loadedDungeon;
+    TimerWheel<SimTimer> loadedTimers;
+    EnemyPool loadedPool;
+
+    // Bools and enums in the records are raw bytes from the file; anything
+    // out of range refuses the load like any other bad snapshot
+    auto validEntity = [](const Entity::SavedState& s) { return isValidBool(s.damageFlash); };
+    auto validTimer = [](const SimTimer& t) { return isValidEnum(t.kind, SimTimer::Kind::EnemyFlashEnd); };
+
+    in.read(run);
+    bool loaded = in.ok() && loadedDungeon.readSnapshot(in) && loadedTimers.readSnapshot(in, validTimer) &&
+        in.read(saved) && in.readArray(enemyRecords);
+
+    loaded = loaded && isValidEnum(run.state, GameState::Dead) && isValidBool(run.bossAlive) &&
+        isValidBool(run.bossSpawned) && isValidBool(run.runEnded) && isValidBool(run.attackReady) &&
+        isValidEnum(run.stats.lastHitBy, EnemyRarity::Boss) && validEntity(saved.entity) &&
+        isValidBool(saved.hasDamageBoost) && isValidBool(saved.hasSpeedBoost);
+    for (std::size_t i = 0; loaded && i < enemyRecords.size(); ++i) {
+        const EnemyRecord& r = enemyRecords[i];
+        loaded = validEntity(r.entity) && isValidEnum(r.attackState, Enemy::AttackState::Cooldown) &&
+            isValidBool(r.windupComplete) && isValidEnum(r.rarity, EnemyRarity::Boss);
+    }
+
+    if (loaded) {
+        std::vector<Enemy> loadedEnemies;
+        loadedEnemies.reserve(enemyRecords.size() + 1); // + boss
+        for (const EnemyRecord& r : enemyRecords) {
+            Enemy& e = loadedEnemies.emplace_back(r.entity.position, dungeon);
+            if (r.rarity == EnemyRarity::Boss) e.makeBoss();
+            e.rarity = r.rarity;
+            e.loadState(r.entity);
+            e.attackState = r.attackState;
+            e.windupComplete = r.windupComplete;
+            e.attackTimer = r.attackTimer;
+        }
+        loaded = loadedPool.readSnapshot(in, std::move(loadedEnemies)) && in.readArray(pickupRecords) && in.atEnd();
+    }
+    for (std::size_t i = 0; loaded && i < pickupRecords.size(); ++i)
+        loaded = isValidEnum(pickupRecords[i].type, Pickup::Type::SpeedBoost);
+
+    if (!loaded)
+        return false;
+
+    dungeon.adoptSnapshot(loadedDungeon);
+    timers = std::move(loadedTimers);
+    enemies = std::move(loadedPool);
+
+    seed = run.seed;
+    tick = run.tick;
+    state = run.state;
+    bossAlive = run.bossAlive;
+    bossSpawned = run.bossSpawned;
+    runEnded = run.runEnded;
+    attackReady = run.attackReady;
+    enemiesDefeated = run.enemiesDefeated;
+    floorNumber = run.floorNumber;
+    enemiesKilledThisFloor = run.enemiesKilledThisFloor;
+    enemiesToClear = run.enemiesToClear;
+    enemiesToClearThisFloor = run.enemiesToClearThisFloor;
+    enemiesToSpawn = run.enemiesToSpawn;
+    floorSize = run.floorSize;
+    pickupRadius = run.pickupRadius;
+    bossHandle = run.bossHandle;
+    spawnRng = run.spawnRng;
+    lootRng = run.lootRng;
+    combatRng = run.combatRng;
+    runStats = run.stats;
+
+    player.loadState(saved.entity);
+    player.damageBoost.reset();
+    player.speedBoost.reset();
+    if (saved.hasDamageBoost) player.damageBoost = saved.damageBoost;
+    if (saved.hasSpeedBoost) player.speedBoost = saved.speedBoost;
+
+    pickups.clear();
+    for (const PickupRecord& p : pickupRecords)
+        pickups.emplace_back(p.position, p.type, p.value, p.duration);
+
+    rebuildSpatialHash();
+    pursuit.invalidate();
+    dungeon.setFocus(static_cast<int>(player.getPosition().x / TILE_SIZE),
+        static_cast<int>(player.getPosition().y / TILE_SIZE));
+
+    events.clear();
+    events.floorStarted = true; // views rebuild as for a new floor
+    prefetcher.request(nextFloorKey());
+    return true;
+}
+
+FloorKey Simulation::floorKey(int floor, int enemyCount) const {
+    return { seed, floor, floorSize, enemyCount };
+}
+
+// Mirrors advanceFloor
+FloorKey Simulation::nextFloorKey() const {
+    return floorKey(floorNumber + 1, enemiesToSpawn + floorNumber + 3);
+}
+
+void Simulation::setFloorSize(sf::Vector2i size) {
+    floorSize = size;
+    prefetcher.request(nextFloorKey());
+}
+
+void Simulation::startFloor() {
+    PROFILE_SCOPE("Simulation::startFloor");
+    auto start = std::chrono::steady_clock::now();
+
+    // Built in the background if we're lucky; the same plan either way
+    FloorKey key = floorKey(floorNumber, enemiesToSpawn);
+    bool prefetched = prefetcher.take(key, floorPlan);
+    if (!prefetched) {
+        floorPlan.key = key;
+        buildFloorPlan(floorPlan);
+    }
+
+    dungeon.adoptLayout(floorPlan.dungeon);
+    spawnRng = floorPlan.spawnRng;
+    dungeon.clearDiscovery();
+    pursuit.invalidate();
+
+    player.setPosition(floorPlan.spawnPoint);
+    dungeon.setFocus(static_cast<int>(player.getPosition().x / TILE_SIZE),
+        static_cast<int>(player.getPosition().y / TILE_SIZE));
+
+    enemies.clear();
+    bossHandle = {};
+    pickups.clear();
+
+    rebuildSpatialHash();
+    enemies.reserve(enemiesToSpawn + 1); // + boss
+    for (const auto& pos : floorPlan.enemyPositions)
+        addEnemy(pos);
+
+    enemiesKilledThisFloor = 0;
+    enemiesToClear = static_cast<int>(enemiesToSpawn * 0.4f); // 60%
+    enemiesToClearThisFloor = enemiesToClear;
+
+    events.floorStarted = true;
+
+    float millis = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    floorSwaps.lastMillis = millis;
+    floorSwaps.maxMillis = std::max(floorSwaps.maxMillis, millis);
+    floorSwaps.lastPrefetched = prefetched;
+    floorSwaps.swaps++;
+    if (prefetched) floorSwaps.prefetched++;
+
+    prefetcher.request(nextFloorKey());
+}
+
+void Simulation::advanceFloor() {
+    floorNumber++;
+    enemiesToSpawn += floorNumber + 2;
+    player.setHealth(player.getHealth() + 10.f); // heal some on floor advance
+    startFloor();
+}
+
+void Simulation::collectPickups()
+{
+    PROFILE_SCOPE("Simulation::collectPickups");
+    auto pit = pickups.begin();
+    while (pit != pickups.end()) {
+
+        sf::Vector2f delta = pit->position - player.getCenter();
+        float distSq = delta.x * delta.x + delta.y * delta.y;
+
+        if (distSq < pickupRadius) { // pickup radius
+            events.pickupsCollected.push_back({ pit->position, pit->type, pit->value });
+
+            switch (pit->type) {
+            case Pickup::Type::Heal:
+                player.setHealth(player.getHealth() + pit->value);
+                break;
+
+            case Pickup::Type::DamageBoost:
+                if (player.damageBoost)
+                    timers.cancel(player.damageBoost->expiry);
+                player.damageBoost = TimedBoost{ pit->value,
+                    timers.scheduleIn(Constants::Sim::ticksFor(pit->duration), { SimTimer::Kind::DamageBoostEnd }) };
+                break;
+
+            case Pickup::Type::SpeedBoost:
+                if (player.speedBoost)
+                    timers.cancel(player.speedBoost->expiry);
+                player.speedBoost = TimedBoost{ pit->value,
+                    timers.scheduleIn(Constants::Sim::ticksFor(pit->duration), { SimTimer::Kind::SpeedBoostEnd }) };
+                player.setSpeed(140.f + pit->value);
+                break;
+            }
+
+
+            pit = pickups.erase(pit);
+        }
+        else {
+            ++pit;
+        }
+    }
+}
+
+void Simulation::rebuildSpatialHash()
+{
+    spatial.clear();
+    player.spatialProxy = spatial.insert(player.getBounds(), &player);
+    for (auto& e : enemies)
+        e.spatialProxy = spatial.insert(e.getBounds(), &e);
+}
+
+EnemyHandle Simulation::addEnemy(const sf::Vector2f& pos)
+{
+    const Enemy* storage = enemies.data();
+    EnemyHandle handle = enemies.emplace(pos, dungeon);
+
+    // Growing the pool moved every enemy; repoint the broadphase at them
+    if (enemies.data() != storage) {
+        for (std::size_t i = 0; i + 1 < enemies.size(); ++i)
+            spatial.setOwner(enemies[i].spatialProxy, &enemies[i]);
+    }
+
+    Enemy& enemy = *enemies.get(handle);
+    enemy.spatialProxy = spatial.insert(enemy.getBounds(), &enemy);
+    enemy.attackTimer = timers.scheduleIn(Enemy::AttackCooldownTicks, { SimTimer::Kind::EnemyCooldownOver, handle });
+    return handle;
+}
+
+void Simulation::removeEnemyAt(std::size_t index)
+{
+    spatial.remove(enemies[index].spatialProxy);
+    enemies.removeAt(index);
+
+    // The last enemy was moved into the hole
+    if (index < enemies.size())
+        spatial.setOwner(enemies[index].spatialProxy, &enemies[index]);
+}
+
+void Simulation::handlePlayerAttack() {
+    PROFILE_SCOPE("Simulation::handlePlayerAttack");
+
+    sf::Vector2f playerCenter = player.getCenter();
+    sf::FloatRect attackArea{
+        playerCenter - sf::Vector2f{ AttackRadius, AttackRadius },
+        sf::Vector2f{ 2.f * AttackRadius, 2.f * AttackRadius } };
+
+    spatial.query(attackArea, [&](SpatialHash::ProxyId id) {
+        if (id == player.spatialProxy) return;
+        Enemy& enemy = static_cast<Enemy&>(*spatial.getOwner(id)); // everything else is an enemy
+
+        sf::FloatRect enemyBounds = enemy.getBounds();
+
+        float left = enemyBounds.position.x;
+        float right = enemyBounds.position.x + enemyBounds.size.x;
+        float top = enemyBounds.position.y;
+        float bottom = enemyBounds.position.y + enemyBounds.size.y;
+
+        float closestX = std::clamp(playerCenter.x, left, right);
+        float closestY = std::clamp(playerCenter.y, top, bottom);
+
+        float dx = playerCenter.x - closestX;
+        float dy = playerCenter.y - closestY;
+
+        float distSq = dx * dx + dy * dy;
+
+        if (distSq <= AttackRadius * AttackRadius) {
+            float Playerdamage = rollDamage(35.f, 45.f);
+            if (player.damageBoost)
+                Playerdamage += player.damageBoost->value;
+            enemy.takeDamage(Playerdamage);  // Deal damage
+            startDamageFlash(enemy, { SimTimer::Kind::EnemyFlashEnd, enemies.handleOf(enemy) });
+
+            events.hits.push_back({
+                enemy.getCenter(),
+                Playerdamage,
+                enemy.isBoss() ? sf::Color(255, 120, 120) : sf::Color::White
+            });
+        }
+    });
+
+    bool bossKilledThisFrame = false;
+
+    // Remove dead enemies
+    for (std::size_t i = 0; i < enemies.size();) {
+        Enemy& enemy = enemies[i];
+        if (enemy.isDead()) {
+
+            if (enemy.isBoss()) {
+                bossKilledThisFrame = true;
+            }
+            // Spawn pickup at enemy center
+            //if (std::uniform_real_distribution<float>(0.f, 1.f)(rng) <= PickupSpawnChance) {
+                //spawnPickup(it->getCenter());
+            //}
+
+            events.kills.push_back({ enemy.getCenter(), enemy.rarity });
+            runStats.killsByRarity[static_cast<std::size_t>(enemy.rarity)]++;
+            auto drops = loot.rollDrops(enemy.rarity, scratch.resource());
+
+            for (auto& p : drops)
+            {
+                float angle = lootRng.uniformFloat(0.f, 2.f * 3.1415926f);
+                float radius = lootRng.uniformFloat(5.f, 18.f); // tweak range 12.f, 28.f
+
+                sf::Vector2f offset(
+                    std::cos(angle) * radius,
+                    std::sin(angle) * radius
+                );
+
+                pickups.emplace_back(
+                    enemy.getCenter() + offset,
+                    p.type,
+                    p.value,
+                    p.duration
+                );
+            }
+
+
+            removeEnemyAt(i); // swaps the last enemy in, so don't advance
+            enemiesDefeated++;
+            enemiesKilledThisFloor++;
+            if (enemiesToClearThisFloor > 0)
+                enemiesToClearThisFloor--;
+        }
+        else {
+            ++i;
+        }
+    }
+
+    if (!bossSpawned && enemiesKilledThisFloor >= BossSpawnThreshold  && floorNumber % BossFloorInterval == 0) {
+        spawnBoss();
+        bossSpawned = true;
+        bossAlive = true;
+    }
+
+    if (bossKilledThisFrame) {
+        bossAlive = false;
+        return;
+    }
+
+    attackReady = false;
+    timers.scheduleIn(AttackCooldownTicks, { SimTimer::Kind::PlayerAttackReady });
+    events.attackEffect = SimEvents::AttackEffect{
+        player.getCenter(),
+        AttackRadius,
+        sf::Color(0, 255, 0, 100)
+    };
+}
+
+void Simulation::handleEnemyAttacks(float dt)
+{
+    PROFILE_SCOPE("Simulation::handleEnemyAttacks");
+    // Decide: every enemy works out where it wants to go from the state at
+    // the start of this phase. Read-only, so it is spread over all cores.
+    sf::Vector2f playerPos = player.getPosition();
+    enemyIntents.resize(enemies.size());
+    workers.parallelFor(enemies.size(), EnemyDecideGrain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            enemyIntents[i] = enemies[i].decide(playerPos, pursuit, dt);
+    });
+
+    // Resolve: moves against other entities, attacks and damage, one enemy
+    // at a time in pool order so the outcome never depends on thread timing.
+    for (std::size_t i = 0; i < enemies.size(); ++i) {
+        Enemy& enemy = enemies[i];
+        enemy.applyIntent(enemyIntents[i], spatial);
+        spatial.update(enemy.spatialProxy, enemy.getBounds());
+
+        sf::FloatRect playerBounds = player.getBounds();
+        sf::Vector2f enemyCenter = enemy.getCenter();
+
+
+        float left = playerBounds.position.x;
+        float right = playerBounds.position.x + playerBounds.size.x;
+        float top = playerBounds.position.y;
+        float bottom = playerBounds.position.y + playerBounds.size.y;
+
+        float closestX = std::clamp(enemyCenter.x, left, right);
+        float closestY = std::clamp(enemyCenter.y, top, bottom);
+
+        float dx = enemyCenter.x - closestX;
+        float dy = enemyCenter.y - closestY;
+
+        float distSq = dx * dx + dy * dy;
+        float rangeSq = Enemy::AttackRange * Enemy::AttackRange;
+
+        if (distSq <= rangeSq)
+        {
+            if (enemy.canAttack())
+            {
+                enemy.startWindup();
+                enemy.attackTimer = timers.scheduleIn(Enemy::AttackWindupTicks,
+                    { SimTimer::Kind::EnemyWindupDone, enemies.handleOf(enemy) });
+            }
+
+            if (enemy.isWindingUp() && enemy.windupComplete)
+            {
+                float enemyDmg = rollDamage(Enemy::AttackDamageMax, Enemy::AttackDamageMin);
+                enemyDmg += (floorNumber - 1) * 2.f; // scale with floor
+                player.takeDamage(enemyDmg);
+                runStats.lastHitBy = enemy.rarity;
+                startDamageFlash(player, { SimTimer::Kind::PlayerFlashEnd });
+
+                events.hits.push_back({
+                    player.getCenter(),
+                    enemyDmg,
+                    sf::Color(255, 80, 80),
+                    true
+                });
+
+                int alpha = static_cast<int>(std::clamp(enemyDmg * 10.f, 80.f, 160.f));
+                events.attackEffect = SimEvents::AttackEffect{
+                    enemy.getCenter(),
+                    Enemy::AttackRange,
+                    sf::Color(255, 80, 80, static_cast<std::uint8_t>(alpha))
+                };
+
+                enemy.finishAttack();
+                enemy.attackTimer = timers.scheduleIn(Enemy::AttackCooldownTicks,
+                    { SimTimer::Kind::EnemyCooldownOver, enemies.handleOf(enemy) });
+            }
+        }
+        else if (enemy.isWindingUp())
+        {
+            timers.cancel(enemy.attackTimer);
+            enemy.cancelWindup();
+        }
+    }
+}
+
+void Simulation::spawnBoss()
+{
+    // Somewhere near but not on top of the player, with room for the bigger body
+    SpawnQuery query;
+    query.awayFrom = player.getPosition();
+    query.minDistance = BossMinSpawnDist;
+    query.maxDistance = BossMaxSpawnDist;
+    query.clearance = 2;
+
+    std::pmr::vector<sf::Vector2f> picked(scratch.resource());
+    if (dungeon.sampleFloorTiles(spawnRng, 1, query, picked) == 0) {
+        // Fallback: if no tile fits, relax the constraint
+        query.minDistance = 0.f;
+        query.maxDistance = -1.f;
+        if (dungeon.sampleFloorTiles(spawnRng, 1, query, picked) == 0)
+            return;
+    }
+
+    sf::Vector2f bossPos = picked.front() + sf::Vector2f{ TILE_SIZE * 0.5f, TILE_SIZE * 0.5f };
+
+    bossHandle = addEnemy(bossPos);
+    Enemy& boss = *enemies.get(bossHandle);
+    boss.makeBoss();
+    spatial.update(boss.spatialProxy, boss.getBounds()); // bigger now
+}
+
+void Simulation::endRun() {
+    state = GameState::Dead;
+    bossAlive = false; // reuse Dead for now
+    pickups.clear();
+    events.runEnded = true;
+}
+
+float Simulation::rollDamage(float min, float max)
+{
+    return combatRng.uniformFloat(min, max);
+}
+
+void Simulation::spawnPickup(const sf::Vector2f& pos)
+{
+    if (enemyDropTable.empty())
+        return;
+
+    float totalWeight = 0.f;
+    for (const auto& e : enemyDropTable)
+        totalWeight += e.chance;
+
+    float roll = lootRng.uniformFloat(0.f, totalWeight);
+
+    float accum = 0.f;
+    for (const auto& e : enemyDropTable) {
+        accum += e.chance;
+        if (roll <= accum) {
+
+            pickups.emplace_back(
+                pos,
+                e.type,
+                e.value,
+                e.duration
+            );
+
+            return;
+        }
+    }
+}
@@ -0,0 +1,225 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include <vector>
+#include "Dungeon.hpp"
+#include "Player.hpp"
+#include "Enemy.hpp"
+#include "FloorPrefetcher.hpp"
+#include "FrameArena.hpp"
+#include "FlowField.hpp"
+#include "Loot.hpp"
+#include "Random.hpp"
+#include "SpatialHash.hpp"
+#include "TimerWheel.hpp"
+#include "WorkerPool.hpp"
+#include "SimInput.hpp"
+#include "Snapshot.hpp"
+
+// What happened during the last step that a front end may want to show.
+// Cleared at the start of every step.
+struct SimEvents {
+    struct Hit {
+        sf::Vector2f position;
+        float amount;
+        sf::Color color;
+        bool toPlayer = false;
+    };
+
+    struct Kill {
+        sf::Vector2f position;
+        EnemyRarity rarity;
+    };
+
+    struct PickupCollected {
+        sf::Vector2f position;
+        Pickup::Type type;
+        float value;
+    };
+
+    struct AttackEffect {
+        sf::Vector2f position;
+        float radius;
+        sf::Color color;
+    };
+
+    std::vector<Hit> hits;
+    std::vector<Kill> kills;
+    std::vector<PickupCollected> pickupsCollected;
+    std::optional<AttackEffect> attackEffect;
+    bool floorStarted = false;  // new map, minimap needs a full rebuild
+    bool revealedTiles = false; // markVisible uncovered something new
+    bool runEnded = false;
+
+    void clear() {
+        hits.clear();
+        kills.clear();
+        pickupsCollected.clear();
+        attackEffect.reset();
+        floorStarted = false;
+        revealedTiles = false;
+        runEnded = false;
+    }
+};
+
+// How long starting a floor took, from the call to the first playable tick.
+// A floor the prefetcher had ready is a swap; otherwise it was built on the spot.
+struct FloorSwapStats {
+    float lastMillis = 0.f;
+    float maxMillis = 0.f;
+    bool lastPrefetched = false;
+    int swaps = 0;
+    int prefetched = 0;
+};
+
+// Deadlines the simulation waits on. Enemy timers refer to their enemy by
+// handle, so a timer that outlives its enemy just finds nothing.
+struct SimTimer {
+    // 32 bits, so a SimTimer has no padding to carry into snapshots
+    enum class Kind : std::uint32_t {
+        PlayerAttackReady,
+        PlayerFlashEnd,
+        DamageBoostEnd,
+        SpeedBoostEnd,
+        EnemyWindupDone,
+        EnemyCooldownOver,
+        EnemyFlashEnd
+    };
+
+    Kind kind = Kind::PlayerAttackReady;
+    EnemyHandle enemy = {};
+};
+
+// Per-run counters for the run history, reset by restart(). lastHitBy is
+// what killed the player once the run has ended.
+struct RunStats {
+    std::uint64_t startTick = 0;
+    std::uint32_t killsByRarity[EnemyRarityCount] = {};
+    std::uint32_t peakEnemies = 0;
+    EnemyRarity lastHitBy = EnemyRarity::Common;
+    std::uint32_t padding = 0; // saved as raw bytes; keeps the tail zeroed
+};
+
+// Headless gameplay core: dungeon, player, enemies, pickups and loot.
+// Steps one tick from a SimInput and never touches a window or the keyboard.
+class Simulation {
+public:
+    enum class GameState {
+        Playing,
+        Dead
+    };
+
+    explicit Simulation(std::uint64_t seed,
+        sf::Vector2i floorSize = { Constants::Map::DEFAULT_MAP_WIDTH, Constants::Map::DEFAULT_MAP_HEIGHT });
+
+    void step(const SimInput& input, float dt);
+    void restart(std::uint64_t newSeed);
+
+    // Complete run state between two steps, for quick-save (SaveSystem does
+    // the file side). A refused load leaves the current run untouched.
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+
+    std::uint64_t getSeed() const { return seed; }
+    std::uint64_t getTick() const { return tick; }
+
+    // Size of floors generated from now on, in tiles
+    void setFloorSize(sf::Vector2i size);
+    sf::Vector2i getFloorSize() const { return floorSize; }
+
+    const SimEvents& getEvents() const { return events; }
+    const FloorSwapStats& getFloorSwapStats() const { return floorSwaps; }
+    const RunStats& getRunStats() const { return runStats; }
+    GameState getState() const { return state; }
+
+    const Dungeon& getDungeon() const { return dungeon; }
+    const Player& getPlayer() const { return player; }
+    const EnemyPool& getEnemies() const { return enemies; }
+    const std::vector<Pickup>& getPickups() const { return pickups; }
+
+    int getFloorNumber() const { return floorNumber; }
+    int getEnemiesDefeated() const { return enemiesDefeated; }
+    int getEnemiesToClearThisFloor() const { return enemiesToClearThisFloor; }
+    bool canAdvanceFloor() const { return enemiesKilledThisFloor >= enemiesToClear; }
+    EnemyHandle getBossHandle() const { return bossAlive ? bossHandle : EnemyHandle{}; }
+
+private:
+    Dungeon dungeon;
+    Player player;
+    EnemyPool enemies;
+    EnemyHandle bossHandle;
+    std::vector<Pickup> pickups;
+    SpatialHash spatial{ TILE_SIZE }; // player + enemies
+    FlowField pursuit; // distance-to-player map shared by all enemies
+    WorkerPool workers;
+    std::vector<Enemy::Intent> enemyIntents; // per enemy, rebuilt every tick
+    std::vector<DropEntry> enemyDropTable;
+
+    // The next floor is built in the background while this one is played;
+    // floorPlan holds the last plan swapped in, and its buffers are reused.
+    FloorPrefetcher prefetcher;
+    FloorPlan floorPlan;
+    FloorSwapStats floorSwaps;
+    RunStats runStats;
+
+    // One run seed fanned out into per-subsystem streams. Generation and
+    // spawning are re-keyed per floor so a floor only depends on (seed, floor).
+    std::uint64_t seed = 0;
+    std::uint64_t tick = 0;
+    RandomStream spawnRng;
+    RandomStream lootRng;
+    RandomStream combatRng;
+    LootSystem loot;
+    SimEvents events;
+    FrameArena scratch; // containers that don't outlive a step; reset at the start of each
+    TimerWheel<SimTimer> timers; // paused while dead, reset on restart
+
+    GameState state = GameState::Playing;
+    bool bossAlive = true;
+    bool bossSpawned = false;
+    bool runEnded = false;
+    int enemiesDefeated = 0;
+    int floorNumber = 1;
+    int enemiesKilledThisFloor = 0;
+    int enemiesToClear = 0;
+    int enemiesToClearThisFloor = 0;
+    int enemiesToSpawn = 6;
+    sf::Vector2i floorSize;
+
+    bool attackReady = false;
+    bool canAttack() const { return attackReady; }
+
+    // Gameplay constants
+    static constexpr float AttackRadius = 40.f;
+    static constexpr int EnemiesPerRoom = 10;
+    static constexpr float EnemyContactDPS = 30.f;
+    static constexpr int AttackCooldownMs = 500;
+    static constexpr std::uint64_t AttackCooldownTicks = Constants::Sim::ticksFor(AttackCooldownMs / 1000.f);
+    static constexpr std::uint64_t DamageFlashTicks = Constants::Sim::ticksFor(0.1f);
+    static constexpr int VisionRadiusTiles = 5;
+    static constexpr float BossSpawnThreshold = 7; // enemies defeated before boss spawns
+    static constexpr int BossFloorInterval = 5; // spawn boss every X floors
+    static constexpr float BossMinSpawnDist = 6.f * TILE_SIZE;
+    static constexpr float BossMaxSpawnDist = 12.f * TILE_SIZE;
+    static constexpr float PickupSpawnChance = 0.9f; // X% chance to drop a pickup
+    static constexpr std::size_t EnemyDecideGrain = 256; // enemies per parallel work item
+    float pickupRadius = 1000.f;
+
+    void update(float dt);
+    void startFloor();
+    FloorKey floorKey(int floor, int enemyCount) const;
+    FloorKey nextFloorKey() const;
+    void advanceFloor();
+    void handlePlayerAttack();
+    void handleEnemyAttacks(float dt);
+    void rebuildSpatialHash();
+    EnemyHandle addEnemy(const sf::Vector2f& pos);
+    void removeEnemyAt(std::size_t index);
+    void onTimer(const SimTimer& timer);
+    void startDamageFlash(Entity& target, const SimTimer& end);
+    void collectPickups();
+    void spawnBoss();
+    void endRun();
+    float rollDamage(float min, float max);
+    void spawnPickup(const sf::Vector2f& pos);
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Snapshot.hpp"
+
+// Dense storage with stable generational handles.
+// Items sit contiguously (iteration is a plain vector walk); removal moves
+// the last item into the hole, so both insert and remove are O(1). A handle
+// is (slot, generation): when an item is removed its slot's generation is
+// bumped, so old handles to it simply stop resolving instead of dangling.
+//
+// Item addresses are NOT stable: removal moves the last item and growth
+// reallocates. Anything that must outlive a frame should hold a Handle.
+template <typename T>
+class SlotMap {
+public:
+    struct Handle {
+        static constexpr std::uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        std::uint32_t index = InvalidIndex;
+        std::uint32_t generation = 0;
+
+        bool isValid() const { return index != InvalidIndex; }
+        bool operator==(const Handle& o) const { return index == o.index && generation == o.generation; }
+        bool operator!=(const Handle& o) const { return !(*this == o); }
+    };
+
+    template <typename... Args>
+    Handle emplace(Args&&... args) {
+        std::uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            slot = static_cast<std::uint32_t>(slots.size());
+            slots.push_back({});
+        }
+
+        slots[slot].dense = static_cast<std::uint32_t>(items.size());
+        items.emplace_back(std::forward<Args>(args)...);
+        denseToSlot.push_back(slot);
+        return { slot, slots[slot].generation };
+    }
+
+    bool remove(Handle h) {
+        if (!contains(h)) return false;
+        removeAt(slots[h.index].dense);
+        return true;
+    }
+
+    // Removes items[denseIndex]; the last item (if any) takes its place
+    void removeAt(std::size_t denseIndex) {
+        std::uint32_t slot = denseToSlot[denseIndex];
+        ++slots[slot].generation;
+        freeSlots.push_back(slot);
+
+        std::size_t last = items.size() - 1;
+        if (denseIndex != last) {
+            items[denseIndex] = std::move(items[last]);
+            denseToSlot[denseIndex] = denseToSlot[last];
+            slots[denseToSlot[denseIndex]].dense = static_cast<std::uint32_t>(denseIndex);
+        }
+        items.pop_back();
+        denseToSlot.pop_back();
+    }
+
+    bool contains(Handle h) const {
+        return h.index < slots.size() && slots[h.index].generation == h.generation;
+    }
+
+    T* get(Handle h) { return contains(h) ? &items[slots[h.index].dense] : nullptr; }
+    const T* get(Handle h) const { return contains(h) ? &items[slots[h.index].dense] : nullptr; }
+
+    Handle handleAt(std::size_t denseIndex) const {
+        std::uint32_t slot = denseToSlot[denseIndex];
+        return { slot, slots[slot].generation };
+    }
+
+    // Handle of an item currently stored in this map
+    Handle handleOf(const T& item) const {
+        return handleAt(static_cast<std::size_t>(&item - items.data()));
+    }
+
+    // Invalidates every outstanding handle
+    void clear() {
+        for (std::uint32_t slot : denseToSlot) {
+            ++slots[slot].generation;
+            freeSlots.push_back(slot);
+        }
+        items.clear();
+        denseToSlot.clear();
+    }
+
+    void reserve(std::size_t n) { items.reserve(n); denseToSlot.reserve(n); }
+
+    std::size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    const T* data() const { return items.data(); }
+
+    T& operator[](std::size_t denseIndex) { return items[denseIndex]; }
+    const T& operator[](std::size_t denseIndex) const { return items[denseIndex]; }
+
+    // Slot bookkeeping for save states. The owner saves the items itself, in
+    // dense order, and hands them back on load so saved handles still resolve.
+    void writeSnapshot(SnapshotWriter& out) const {
+        out.writeArray(denseToSlot);
+        out.writeArray(slots);
+        out.writeArray(freeSlots);
+    }
+
+    bool readSnapshot(SnapshotReader& in, std::vector<T>&& loadedItems) {
+        in.readArray(denseToSlot);
+        in.readArray(slots);
+        in.readArray(freeSlots);
+
+        bool consistent = in.ok() && denseToSlot.size() == loadedItems.size();
+        for (std::size_t i = 0; consistent && i < denseToSlot.size(); ++i)
+            consistent = denseToSlot[i] < slots.size() && slots[denseToSlot[i]].dense == i;
+        for (std::uint32_t slot : freeSlots)
+            consistent = consistent && slot < slots.size();
+        if (!consistent) {
+            in.fail();
+            items.clear();
+            denseToSlot.clear();
+            slots.clear();
+            freeSlots.clear();
+            return false;
+        }
+
+        items = std::move(loadedItems);
+        return true;
+    }
+
+    auto begin() { return items.begin(); }
+    auto end() { return items.end(); }
+    auto begin() const { return items.begin(); }
+    auto end() const { return items.end(); }
+
+private:
+    struct Slot {
+        std::uint32_t dense = 0;
+        std::uint32_t generation = 0;
+    };
+
+    std::vector<T> items;
+    std::vector<std::uint32_t> denseToSlot;
+    std::vector<Slot> slots;
+    std::vector<std::uint32_t> freeSlots;
+};
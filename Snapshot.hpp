@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Flat binary buffers for save states. Values are stored as their raw bytes
+// and arrays as one length-prefixed block, so reading one back is a memcpy,
+// not parsing. Only trivially copyable types go in; anything with pointers or
+// SFML objects inside is converted to a plain record first.
+//
+// Same-machine format: no endian or padding conversion. The file header
+// (see SaveSystem) carries a version so incompatible snapshots are refused.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<std::uint8_t>& out) : out(out) {}
+
+    void writeBytes(const void* data, std::size_t size) {
+        std::size_t at = out.size();
+        out.resize(at + size);
+        if (size) std::memcpy(out.data() + at, data, size);
+    }
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const T* data, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(static_cast<std::uint64_t>(count));
+        writeBytes(data, count * sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const std::vector<T>& values) { writeArray(values.data(), values.size()); }
+
+private:
+    std::vector<std::uint8_t>& out;
+};
+
+// Bools and enums come back from a snapshot as whatever bytes the file held.
+// A bool other than 0 or 1 is undefined behaviour to use and an enum past its
+// last value indexes out of bounds later, so loads check them with these.
+inline bool isValidBool(const bool& value) {
+    unsigned char byte;
+    std::memcpy(&byte, &value, 1);
+    return byte <= 1;
+}
+
+template <typename E>
+bool isValidEnum(E value, E last) {
+    using U = std::make_unsigned_t<std::underlying_type_t<E>>;
+    return static_cast<U>(value) <= static_cast<U>(last);
+}
+
+// Reads what SnapshotWriter wrote. Every read is bounds checked; after the
+// first failure all reads fail, so callers can check ok() once at the end.
+class SnapshotReader {
+public:
+    SnapshotReader(const std::uint8_t* data, std::size_t size) : cursor(data), end(data + size) {}
+
+    bool ok() const { return good; }
+    bool atEnd() const { return cursor == end; }
+
+    bool readBytes(void* data, std::size_t size) {
+        if (!good || static_cast<std::size_t>(end - cursor) < size) return good = false;
+        if (size) std::memcpy(data, cursor, size);
+        cursor += size;
+        return true;
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return readBytes(&value, sizeof(T));
+    }
+
+    // Length prefix of an array, refused if the rest of the buffer is too
+    // short to hold that many elements
+    template <typename T>
+    bool readCount(std::size_t& count) {
+        std::uint64_t n = 0;
+        if (!read(n)) return false;
+        if (n > static_cast<std::uint64_t>(end - cursor) / sizeof(T)) return good = false;
+        count = static_cast<std::size_t>(n);
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::size_t count = 0;
+        if (!readCount<T>(count)) return false;
+        values.resize(count);
+        return readBytes(values.data(), count * sizeof(T));
+    }
+
+    // Exactly `count` elements into `data`
+    template <typename T>
+    bool readArray(T* data, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::size_t stored = 0;
+        if (!readCount<T>(stored)) return false;
+        if (stored != count) return good = false;
+        return readBytes(data, count * sizeof(T));
+    }
+
+    void fail() { good = false; }
+
+private:
+    const std::uint8_t* cursor;
+    const std::uint8_t* end;
+    bool good = true;
+};
@@ -0,0 +1,118 @@
+#include "SpatialHash.hpp"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float cellSize, int bucketCount)
+    : cellSize(cellSize), invCellSize(1.f / cellSize)
+{
+    // Round up to a power of two so the bucket index is a mask
+    std::uint32_t count = 1;
+    while (count < static_cast<std::uint32_t>(bucketCount)) count <<= 1;
+    bucketMask = count - 1;
+    buckets.resize(count);
+}
+
+SpatialHash::CellRange SpatialHash::cellsFor(const sf::FloatRect& bounds) const {
+    return {
+        static_cast<int>(std::floor(bounds.position.x * invCellSize)),
+        static_cast<int>(std::floor(bounds.position.y * invCellSize)),
+        static_cast<int>(std::floor((bounds.position.x + bounds.size.x) * invCellSize)),
+        static_cast<int>(std::floor((bounds.position.y + bounds.size.y) * invCellSize))
+    };
+}
+
+std::uint32_t SpatialHash::bucketIndex(int cellX, int cellY) const {
+    std::uint32_t h = static_cast<std::uint32_t>(cellX) * 73856093u ^ static_cast<std::uint32_t>(cellY) * 19349663u;
+    return h & bucketMask;
+}
+
+void SpatialHash::link(ProxyId id, const CellRange& cells) {
+    for (int cy = cells.minY; cy <= cells.maxY; ++cy)
+        for (int cx = cells.minX; cx <= cells.maxX; ++cx)
+            buckets[bucketIndex(cx, cy)].push_back({ id, cx, cy });
+}
+
+void SpatialHash::unlink(ProxyId id, const CellRange& cells) {
+    for (int cy = cells.minY; cy <= cells.maxY; ++cy) {
+        for (int cx = cells.minX; cx <= cells.maxX; ++cx) {
+            auto& bucket = buckets[bucketIndex(cx, cy)];
+            for (std::size_t i = 0; i < bucket.size(); ++i) {
+                if (bucket[i].id == id && bucket[i].cellX == cx && bucket[i].cellY == cy) {
+                    bucket[i] = bucket.back();
+                    bucket.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+SpatialHash::ProxyId SpatialHash::insert(const sf::FloatRect& bounds, Entity* owner) {
+    ProxyId id;
+    if (!freeList.empty()) {
+        id = freeList.back();
+        freeList.pop_back();
+    }
+    else {
+        id = static_cast<ProxyId>(proxies.size());
+        proxies.emplace_back();
+    }
+
+    if (size() > buckets.size() / 2)
+        rehash(static_cast<std::uint32_t>(buckets.size() * 2));
+
+    Proxy& p = proxies[id];
+    p.bounds = bounds;
+    p.owner = owner;
+    p.cells = cellsFor(bounds);
+    p.alive = true;
+    link(id, p.cells);
+    return id;
+}
+
+void SpatialHash::update(ProxyId id, const sf::FloatRect& bounds) {
+    Proxy& p = proxies[id];
+    p.bounds = bounds;
+
+    CellRange cells = cellsFor(bounds);
+    if (cells == p.cells) return;
+
+    unlink(id, p.cells);
+    p.cells = cells;
+    link(id, cells);
+}
+
+void SpatialHash::remove(ProxyId id) {
+    Proxy& p = proxies[id];
+    if (!p.alive) return;
+
+    unlink(id, p.cells);
+    p.alive = false;
+    p.owner = nullptr;
+    freeList.push_back(id);
+}
+
+void SpatialHash::rehash(std::uint32_t bucketCount) {
+    buckets.assign(bucketCount, {});
+    bucketMask = bucketCount - 1;
+    for (ProxyId id = 0; id < static_cast<ProxyId>(proxies.size()); ++id) {
+        if (proxies[id].alive)
+            link(id, proxies[id].cells);
+    }
+}
+
+void SpatialHash::clear() {
+    for (auto& bucket : buckets) bucket.clear();
+    proxies.clear();
+    freeList.clear();
+}
+
+bool SpatialHash::anyOverlap(const sf::FloatRect& bounds, ProxyId ignore) const {
+    bool hit = false;
+    query(bounds, [&](ProxyId id) {
+        if (hit || id == ignore) return;
+        if (bounds.findIntersection(proxies[id].bounds).has_value())
+            hit = true;
+    });
+    return hit;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class Entity;
+
+// Broadphase for entity-vs-entity collision.
+// Space is cut into tile-sized cells which are hashed into a fixed bucket
+// table, so memory does not depend on map size. Every proxy keeps its own
+// bounds; moving an entity only touches buckets when the set of cells it
+// covers changes, which for walking speeds is rare. The table doubles when
+// it gets crowded so lookups stay O(1) with thousands of entities.
+class SpatialHash {
+public:
+    using ProxyId = int;
+    static constexpr ProxyId InvalidProxy = -1;
+
+    explicit SpatialHash(float cellSize, int bucketCount = 4096);
+
+    ProxyId insert(const sf::FloatRect& bounds, Entity* owner);
+    void update(ProxyId id, const sf::FloatRect& bounds);
+    void remove(ProxyId id);
+    void setOwner(ProxyId id, Entity* owner) { proxies[id].owner = owner; } // owner was moved in memory
+    void clear();
+
+    const sf::FloatRect& getBounds(ProxyId id) const { return proxies[id].bounds; }
+    Entity* getOwner(ProxyId id) const { return proxies[id].owner; }
+    std::size_t size() const { return proxies.size() - freeList.size(); }
+
+    // Calls fn(ProxyId) once for every proxy whose cells touch `area`.
+    // Callers still test the exact bounds. Safe to call from several threads.
+    template <typename Fn>
+    void query(const sf::FloatRect& area, Fn&& fn) const;
+
+    // True if any proxy other than `ignore` overlaps `bounds`
+    bool anyOverlap(const sf::FloatRect& bounds, ProxyId ignore) const;
+
+private:
+    struct CellRange {
+        int minX, minY, maxX, maxY;
+        bool operator==(const CellRange& o) const {
+            return minX == o.minX && minY == o.minY && maxX == o.maxX && maxY == o.maxY;
+        }
+    };
+
+    struct Proxy {
+        sf::FloatRect bounds;
+        Entity* owner = nullptr;
+        CellRange cells{};
+        bool alive = false;
+    };
+
+    struct Entry {
+        ProxyId id;
+        int cellX, cellY;
+    };
+
+    float cellSize;
+    float invCellSize;
+    std::uint32_t bucketMask;
+    std::vector<std::vector<Entry>> buckets;
+    std::vector<Proxy> proxies;
+    std::vector<ProxyId> freeList;
+
+    CellRange cellsFor(const sf::FloatRect& bounds) const;
+    std::uint32_t bucketIndex(int cellX, int cellY) const;
+    void link(ProxyId id, const CellRange& cells);
+    void unlink(ProxyId id, const CellRange& cells);
+    void rehash(std::uint32_t bucketCount);
+};
+
+template <typename Fn>
+void SpatialHash::query(const sf::FloatRect& area, Fn&& fn) const {
+    CellRange range = cellsFor(area);
+
+    for (int cy = range.minY; cy <= range.maxY; ++cy) {
+        for (int cx = range.minX; cx <= range.maxX; ++cx) {
+            for (const Entry& e : buckets[bucketIndex(cx, cy)]) {
+                if (e.cellX != cx || e.cellY != cy) continue; // hash collision
+
+                // A proxy sits in every cell it covers; only report it from the
+                // first cell shared with the query so nothing is seen twice.
+                const CellRange& pc = proxies[e.id].cells;
+                if (cx != std::max(range.minX, pc.minX) || cy != std::max(range.minY, pc.minY))
+                    continue;
+
+                fn(e.id);
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Storage is allocated once up front; tryPush() never blocks or
+// allocates and simply fails when the queue is full.
+//
+// head and tail count items ever popped/pushed and only ever grow; the slot
+// is the count masked by the (power of two) capacity. Each side owns one
+// counter and only reads the other's, and the two live on separate cache
+// lines so the threads don't fight over them.
+template <typename T>
+class SpscQueue {
+public:
+    // Rounded up to a power of two
+    explicit SpscQueue(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) size <<= 1;
+        items.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    std::size_t capacity() const { return items.size(); }
+
+    // Producer only
+    bool tryPush(const T& item) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == items.size()) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == items.size())
+                return false; // full
+        }
+
+        items[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: moves up to maxCount items into out, oldest first
+    std::size_t popBatch(T* out, std::size_t maxCount) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        std::size_t count = std::min(tail.load(std::memory_order_acquire) - h, maxCount);
+
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = items[(h + i) & mask];
+
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> items;
+    std::size_t mask = 0;
+
+    alignas(64) std::atomic<std::size_t> head{ 0 }; // written by the consumer
+    alignas(64) std::atomic<std::size_t> tail{ 0 }; // written by the producer
+    std::size_t cachedHead = 0;                     // producer's last look at head
+};
@@ -0,0 +1,84 @@
+#include "Telemetry.hpp"
+#include <chrono>
+#include <filesystem>
+
+namespace {
+    constexpr std::uint32_t Magic = 0x54524450; // "PDRT"
+    constexpr std::size_t BatchSize = 1024;
+
+    std::string rotatedName(const std::string& path, int index) {
+        return path + "." + std::to_string(index);
+    }
+}
+
+TelemetryLog::TelemetryLog(const Config& config)
+    : config(config), queue(config.queueCapacity), batch(BatchSize) {
+    writer = std::thread(&TelemetryLog::writerLoop, this);
+}
+
+TelemetryLog::~TelemetryLog() {
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+}
+
+void TelemetryLog::writerLoop() {
+    openFile();
+    while (!stopping.load(std::memory_order_acquire)) {
+        // Sleep only once the queue is empty, so a burst is written out in one go
+        if (!drain())
+            std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    }
+    while (drain()) {}
+    file.flush();
+}
+
+bool TelemetryLog::drain() {
+    std::size_t count = queue.popBatch(batch.data(), batch.size());
+
+    std::uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+    if (droppedNow != droppedReported && count < batch.size()) {
+        TelemetryEvent note;
+        note.kind = TelemetryEvent::Kind::Dropped;
+        note.value = static_cast<float>(droppedNow - droppedReported);
+        batch[count++] = note;
+        droppedReported = droppedNow;
+    }
+    if (count == 0)
+        return false;
+
+    std::size_t bytes = count * sizeof(TelemetryEvent);
+    if (fileBytes + bytes > config.maxFileBytes)
+        rotate();
+    if (file.is_open()) {
+        file.write(reinterpret_cast<const char*>(batch.data()), static_cast<std::streamsize>(bytes));
+        fileBytes += bytes;
+    }
+
+    written.fetch_add(count, std::memory_order_relaxed);
+    return true;
+}
+
+void TelemetryLog::openFile() {
+    file.open(config.path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return; // keeps draining the queue, just nowhere to put it
+
+    const std::uint32_t header[3] = { Magic, FormatVersion, sizeof(TelemetryEvent) };
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    fileBytes = sizeof(header);
+}
+
+void TelemetryLog::rotate() {
+    file.close();
+
+    // Failures here (e.g. a file held open elsewhere) only cost history
+    std::error_code ignored;
+    if (config.keepFiles > 0) {
+        std::filesystem::remove(rotatedName(config.path, config.keepFiles), ignored);
+        for (int i = config.keepFiles - 1; i >= 1; --i)
+            std::filesystem::rename(rotatedName(config.path, i), rotatedName(config.path, i + 1), ignored);
+        std::filesystem::rename(config.path, rotatedName(config.path, 1), ignored);
+    }
+
+    openFile();
+}
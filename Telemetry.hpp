@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscQueue.hpp"
+
+// One gameplay or performance sample. Fixed size so the log is just an
+// array of these after the file header.
+struct TelemetryEvent {
+    enum class Kind : std::uint8_t {
+        DamageDealt,     // value = damage
+        DamageTaken,     // value = damage
+        Kill,            // detail = EnemyRarity
+        PickupCollected, // detail = Pickup::Type, value = pickup value
+        FloorStarted,    // value = swap time in ms, detail = 1 if prefetched
+        RunEnded,        // value = enemies defeated
+        FrameTime,       // value = frame time in ms
+        Dropped          // value = events lost to a full queue since the last one (writer only)
+    };
+
+    Kind kind = Kind::FrameTime;
+    std::uint8_t detail = 0;
+    std::uint16_t floor = 0;
+    std::uint32_t tick = 0;
+    float value = 0.f;
+    float x = 0.f; // world position where it applies
+    float y = 0.f;
+};
+static_assert(sizeof(TelemetryEvent) == 20, "telemetry records are written raw");
+
+// Event stream written by a background thread.
+// The game thread push()es into a lock-free queue: never blocks, never
+// allocates, and if the writer falls behind far enough for the queue to fill
+// up, events are dropped and counted (the log records how many). The writer
+// wakes every 25 ms while idle, drains the queue in batches and appends them to
+// `path`; once that passes maxFileBytes it becomes path.1 (path.1 becomes
+// path.2 and so on, up to keepFiles) and a new file starts.
+//
+// File: "PDRT", format version (u32), record size (u32), then records.
+class TelemetryLog {
+public:
+    static constexpr std::uint32_t FormatVersion = 1;
+
+    struct Config {
+        std::string path = "telemetry.bin";
+        std::size_t maxFileBytes = 4 << 20;
+        int keepFiles = 3; // rotated files besides the current one
+        std::size_t queueCapacity = 1 << 14;
+    };
+
+    explicit TelemetryLog(const Config& config);
+    TelemetryLog() : TelemetryLog(Config{}) {}
+    ~TelemetryLog(); // writes out whatever is still queued
+
+    TelemetryLog(const TelemetryLog&) = delete;
+    TelemetryLog& operator=(const TelemetryLog&) = delete;
+
+    // Producer thread only
+    void push(const TelemetryEvent& event) {
+        if (!queue.tryPush(event))
+            dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+    std::uint64_t getWritten() const { return written.load(std::memory_order_relaxed); }
+
+private:
+    Config config;
+    SpscQueue<TelemetryEvent> queue;
+    std::atomic<std::uint64_t> dropped{ 0 };
+    std::atomic<std::uint64_t> written{ 0 };
+    std::atomic<bool> stopping{ false };
+
+    // Writer thread only
+    std::ofstream file;
+    std::size_t fileBytes = 0;
+    std::uint64_t droppedReported = 0;
+    std::vector<TelemetryEvent> batch;
+
+    std::thread writer; // last: starts once everything above exists
+
+    void writerLoop();
+    bool drain();
+    void openFile();
+    void rotate();
+};
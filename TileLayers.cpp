@@ -0,0 +1,474 @@
+#include "TileLayers.hpp"
+
+void TileBits::resize(int w, int h) {
+    width = std::max(w, 0);
+    height = std::max(h, 0);
+    wordsPerRow = (width + 63) / 64;
+    pages.clear();
+    pages.resize(static_cast<std::size_t>(wordsPerRow) * ((height + 63) / 64));
+}
+
+std::uint64_t& TileBits::mutableWord(int y, int w) {
+    auto& page = pages[pageIndex(y, w)];
+    if (!page) page = std::make_unique<Page>(Page{});
+    return (*page)[y & 63];
+}
+
+void TileBits::clear() {
+    for (auto& page : pages) page.reset();
+}
+
+void TileBits::unionWith(const TileBits& other) {
+    if (other.width != width || other.height != height) return;
+    for (std::size_t i = 0; i < pages.size(); ++i) {
+        if (!other.pages[i]) continue;
+        if (!pages[i]) {
+            pages[i] = std::make_unique<Page>(*other.pages[i]);
+            continue;
+        }
+        for (int r = 0; r < 64; ++r)
+            (*pages[i])[r] |= (*other.pages[i])[r];
+    }
+}
+
+bool TileBits::clipSpan(int y, int& x0, int& x1) const {
+    if (y < 0 || y >= height) return false;
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, width - 1);
+    return x0 <= x1;
+}
+
+bool TileBits::anyInSpan(int y, int x0, int x1) const {
+    if (!clipSpan(y, x0, x1)) return false;
+    for (int w = x0 >> 6; w <= (x1 >> 6); ++w) {
+        if (word(y, w) & spanMask(w, x0, x1)) return true;
+    }
+    return false;
+}
+
+void TileBits::clearSpan(int y, int x0, int x1) {
+    if (!clipSpan(y, x0, x1)) return;
+    for (int w = x0 >> 6; w <= (x1 >> 6); ++w) {
+        if (Page* page = pages[pageIndex(y, w)].get())
+            (*page)[y & 63] &= ~spanMask(w, x0, x1);
+    }
+}
+
+int TileBits::countInSpan(int y, int x0, int x1) const {
+    if (!clipSpan(y, x0, x1)) return 0;
+    int n = 0;
+    for (int w = x0 >> 6; w <= (x1 >> 6); ++w)
+        n += std::popcount(word(y, w) & spanMask(w, x0, x1));
+    return n;
+}
+
+bool TileBits::none() const {
+    for (const auto& page : pages) {
+        if (!page) continue;
+        for (std::uint64_t w : *page)
+            if (w) return false;
+    }
+    return true;
+}
+
+std::size_t TileBits::count() const {
+    std::size_t n = 0;
+    for (const auto& page : pages) {
+        if (!page) continue;
+        for (std::uint64_t w : *page) n += std::popcount(w);
+    }
+    return n;
+}
+
+std::size_t TileBits::getAllocatedBytes() const {
+    std::size_t n = 0;
+    for (const auto& page : pages)
+        if (page) n += sizeof(Page);
+    return n;
+}
+
+void TileBits::writeSnapshot(SnapshotWriter& out) const {
+    out.write(width);
+    out.write(height);
+
+    std::vector<std::uint8_t> present(pages.size());
+    for (std::size_t i = 0; i < pages.size(); ++i)
+        present[i] = pages[i] ? 1 : 0;
+    out.writeArray(present);
+
+    for (const auto& page : pages)
+        if (page) out.writeBytes(page->data(), sizeof(Page));
+}
+
+bool TileBits::readSnapshot(SnapshotReader& in) {
+    int w = 0, h = 0;
+    if (!in.read(w) || !in.read(h) || w < 0 || h < 0) return false;
+    resize(w, h);
+
+    std::vector<std::uint8_t> present;
+    if (!in.readArray(present)) return false;
+    if (present.size() != pages.size()) { in.fail(); return false; }
+
+    for (std::size_t i = 0; i < pages.size(); ++i) {
+        if (!present[i]) continue;
+        pages[i] = std::make_unique<Page>();
+        if (!in.readBytes(pages[i]->data(), sizeof(Page))) return false;
+    }
+    return true;
+}
+
+void TileMap::reset(int w, int h, std::uint8_t type) {
+    width = std::max(w, 0);
+    height = std::max(h, 0);
+    chunksX = (width + ChunkSize - 1) >> ChunkShift;
+    chunksY = (height + ChunkSize - 1) >> ChunkShift;
+
+    chunks.clear();
+    chunks.resize(static_cast<std::size_t>(chunksX) * chunksY);
+    for (Chunk& chunk : chunks) chunk.uniform = type;
+    resident.clear();
+    pinX0 = pinY0 = 0;
+    pinX1 = pinY1 = -1;
+}
+
+void TileMap::fill(std::uint8_t type) {
+    for (Chunk& chunk : chunks) {
+        if (chunk.state == State::Resident) {
+            chunk.decoded->types.fill(type);
+            chunk.decoded->solid.fill(type == Tile::Floor ? 0 : ~std::uint64_t(0));
+            continue;
+        }
+        chunk.state = State::Uniform;
+        chunk.uniform = type;
+        chunk.packed.clear();
+        chunk.packed.shrink_to_fit();
+    }
+}
+
+std::uint8_t TileMap::get(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return Tile::Wall;
+
+    const Chunk& chunk = chunks[chunkIndex(x >> ChunkShift, y >> ChunkShift)];
+    int local = ((y & (ChunkSize - 1)) << ChunkShift) + (x & (ChunkSize - 1));
+
+    switch (chunk.state) {
+    case State::Uniform:
+        return chunk.uniform;
+    case State::Resident:
+        return chunk.decoded->types[local];
+    default:
+        for (std::size_t r = 0; r < chunk.packed.size(); r += 2) {
+            local -= chunk.packed[r] + 1;
+            if (local < 0) return chunk.packed[r + 1];
+        }
+        return Tile::Wall;
+    }
+}
+
+bool TileMap::anySolidInRect(int x0, int y0, int x1, int y1) const {
+    if (x0 < 0 || y0 < 0 || x1 >= width || y1 >= height) return true;
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int cx = x0 >> ChunkShift; cx <= (x1 >> ChunkShift); ++cx) {
+            const Chunk& chunk = chunks[chunkIndex(cx, y >> ChunkShift)];
+            int lo = std::max(x0, cx << ChunkShift);
+            int hi = std::min(x1, (cx << ChunkShift) + ChunkSize - 1);
+
+            if (chunk.state == State::Uniform) {
+                if (chunk.uniform != Tile::Floor) return true;
+            }
+            else if (chunk.state == State::Resident) {
+                int a = lo & (ChunkSize - 1), b = hi & (ChunkSize - 1);
+                std::uint64_t upto = b == 63 ? ~std::uint64_t(0) : (std::uint64_t(1) << (b + 1)) - 1;
+                if (chunk.decoded->solid[y & (ChunkSize - 1)] & upto & (~std::uint64_t(0) << a))
+                    return true;
+            }
+            else {
+                for (int x = lo; x <= hi; ++x)
+                    if (get(x, y) != Tile::Floor) return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TileMap::copyRow(int y, int x, int count, std::uint8_t* out) const {
+    while (count > 0) {
+        if (x < 0 || y < 0 || x >= width || y >= height) {
+            *out++ = Tile::Wall;
+            ++x; --count;
+            continue;
+        }
+
+        const Chunk& chunk = chunks[chunkIndex(x >> ChunkShift, y >> ChunkShift)];
+        int lx = x & (ChunkSize - 1);
+        int n = std::min({ count, ChunkSize - lx, width - x });
+
+        if (chunk.state == State::Uniform)
+            std::fill_n(out, n, chunk.uniform);
+        else if (chunk.state == State::Resident)
+            std::copy_n(&chunk.decoded->types[((y & (ChunkSize - 1)) << ChunkShift) + lx], n, out);
+        else {
+            // Skip to the first run that covers the span, then copy runs
+            int local = ((y & (ChunkSize - 1)) << ChunkShift) + lx;
+            std::size_t r = 0;
+            int runStart = 0;
+            while (runStart + chunk.packed[r] + 1 <= local) {
+                runStart += chunk.packed[r] + 1;
+                r += 2;
+            }
+            for (int i = 0; i < n; ) {
+                int runEnd = runStart + chunk.packed[r] + 1;
+                int take = std::min(n - i, runEnd - (local + i));
+                std::fill_n(out + i, take, chunk.packed[r + 1]);
+                i += take;
+                runStart = runEnd;
+                r += 2;
+            }
+        }
+
+        out += n;
+        x += n;
+        count -= n;
+    }
+}
+
+bool TileMap::isPinned(int index) const {
+    int cx = index % chunksX, cy = index / chunksX;
+    return cx >= pinX0 && cx <= pinX1 && cy >= pinY0 && cy <= pinY1;
+}
+
+TileMap::Chunk& TileMap::decode(int index) {
+    Chunk& chunk = chunks[index];
+    chunk.lastUse = ++useClock;
+    if (chunk.state == State::Resident) return chunk;
+
+    chunk.decoded = std::make_unique<Decoded>();
+    auto& types = chunk.decoded->types;
+
+    if (chunk.state == State::Uniform) {
+        types.fill(chunk.uniform);
+    }
+    else {
+        std::size_t i = 0;
+        for (std::size_t r = 0; r < chunk.packed.size(); r += 2) {
+            std::fill_n(types.begin() + i, chunk.packed[r] + 1, chunk.packed[r + 1]);
+            i += chunk.packed[r] + 1;
+        }
+        chunk.packed.clear();
+        chunk.packed.shrink_to_fit();
+    }
+
+    for (int y = 0; y < ChunkSize; ++y) {
+        std::uint64_t row = 0;
+        for (int x = 0; x < ChunkSize; ++x)
+            if (types[(y << ChunkShift) + x] != Tile::Floor) row |= std::uint64_t(1) << x;
+        chunk.decoded->solid[y] = row;
+    }
+
+    chunk.state = State::Resident;
+    resident.push_back(index);
+    enforceBudget(index);
+    return chunk;
+}
+
+void TileMap::compress(int index) {
+    Chunk& chunk = chunks[index];
+    if (chunk.state != State::Resident) return;
+
+    const auto& types = chunk.decoded->types;
+    if (std::all_of(types.begin(), types.end(), [&](std::uint8_t t) { return t == types[0]; })) {
+        chunk.state = State::Uniform;
+        chunk.uniform = types[0];
+    }
+    else {
+        chunk.packed.clear();
+        for (std::size_t i = 0; i < types.size(); ) {
+            std::size_t run = 1;
+            while (run < 256 && i + run < types.size() && types[i + run] == types[i]) ++run;
+            chunk.packed.push_back(static_cast<std::uint8_t>(run - 1));
+            chunk.packed.push_back(types[i]);
+            i += run;
+        }
+        chunk.packed.shrink_to_fit();
+        chunk.state = State::Compressed;
+    }
+
+    chunk.decoded.reset();
+    resident.erase(std::find(resident.begin(), resident.end(), index));
+}
+
+void TileMap::enforceBudget(int keep) {
+    while (resident.size() > budget) {
+        // Least recently used chunk outside the pinned box
+        int victim = -1;
+        for (int index : resident) {
+            if (index == keep || isPinned(index)) continue;
+            if (victim < 0 || chunks[index].lastUse < chunks[victim].lastUse)
+                victim = index;
+        }
+        if (victim < 0) return; // everything is pinned; the budget gives way
+        compress(victim);
+    }
+}
+
+void TileMap::makeResident(int chunkX0, int chunkY0, int chunkX1, int chunkY1) {
+    pinX0 = std::max(chunkX0, 0);
+    pinY0 = std::max(chunkY0, 0);
+    pinX1 = std::min(chunkX1, chunksX - 1);
+    pinY1 = std::min(chunkY1, chunksY - 1);
+
+    for (int cy = pinY0; cy <= pinY1; ++cy)
+        for (int cx = pinX0; cx <= pinX1; ++cx)
+            decode(chunkIndex(cx, cy));
+    enforceBudget();
+}
+
+bool TileMap::isChunkResident(int chunkX, int chunkY) const {
+    if (chunkX < 0 || chunkY < 0 || chunkX >= chunksX || chunkY >= chunksY) return false;
+    return chunks[chunkIndex(chunkX, chunkY)].state == State::Resident;
+}
+
+void TileMap::setResidentBudget(std::size_t chunkCount) {
+    budget = std::max<std::size_t>(chunkCount, 1);
+    enforceBudget();
+}
+
+std::size_t TileMap::getCompressedBytes() const {
+    std::size_t n = 0;
+    for (const Chunk& chunk : chunks) n += chunk.packed.size();
+    return n;
+}
+
+void TileMap::writeSnapshot(SnapshotWriter& out) const {
+    out.write(width);
+    out.write(height);
+    for (const Chunk& chunk : chunks) {
+        out.write(chunk.state);
+        switch (chunk.state) {
+        case State::Uniform:
+            out.write(chunk.uniform);
+            break;
+        case State::Resident:
+            out.write(*chunk.decoded);
+            break;
+        default:
+            out.writeArray(chunk.packed);
+            break;
+        }
+    }
+}
+
+bool TileMap::readSnapshot(SnapshotReader& in) {
+    int w = 0, h = 0;
+    if (!in.read(w) || !in.read(h) || w < 0 || h < 0) return false;
+    reset(w, h, Tile::Wall);
+
+    for (int i = 0; i < static_cast<int>(chunks.size()); ++i) {
+        Chunk& chunk = chunks[i];
+        if (!in.read(chunk.state)) return false;
+        switch (chunk.state) {
+        case State::Uniform:
+            if (!in.read(chunk.uniform)) return false;
+            break;
+        case State::Resident:
+            chunk.decoded = std::make_unique<Decoded>();
+            if (!in.read(*chunk.decoded)) return false;
+            chunk.lastUse = ++useClock;
+            resident.push_back(i);
+            break;
+        case State::Compressed: {
+            if (!in.readArray(chunk.packed)) return false;
+            // Runs must cover the chunk exactly; reads rely on it
+            std::size_t covered = 0;
+            for (std::size_t r = 0; r + 1 < chunk.packed.size(); r += 2)
+                covered += chunk.packed[r] + 1;
+            if (chunk.packed.size() % 2 != 0 || covered != ChunkSize * ChunkSize) {
+                in.fail();
+                return false;
+            }
+            break;
+        }
+        default:
+            in.fail();
+            return false;
+        }
+    }
+    enforceBudget();
+    return true;
+}
+
+int TileMap::countInChunk(int chunkX, int chunkY, std::uint8_t type) const {
+    int seen = 0;
+    selectInChunk(chunkX, chunkY, type, -1, seen);
+    return seen;
+}
+
+int TileMap::findInChunk(int chunkX, int chunkY, std::uint8_t type, int n) const {
+    int seen = 0;
+    return n < 0 ? -1 : selectInChunk(chunkX, chunkY, type, n, seen);
+}
+
+// Position of the n-th tile of `type` (n < 0: none), counting only tiles on
+// the map; seen ends up as the count when it isn't found
+int TileMap::selectInChunk(int chunkX, int chunkY, std::uint8_t type, int n, int& seen) const {
+    const Chunk& chunk = chunks[chunkIndex(chunkX, chunkY)];
+    const int w = chunkWidth(chunkX), h = chunkHeight(chunkY);
+    const std::uint64_t rowMask = w == ChunkSize ? ~std::uint64_t(0) : (std::uint64_t(1) << w) - 1;
+    seen = 0;
+
+    if (chunk.state == State::Uniform) {
+        if (chunk.uniform != type) return -1;
+        if (n >= 0 && n < w * h) return ((n / w) << ChunkShift) + n % w;
+        seen = w * h;
+        return -1;
+    }
+
+    if (chunk.state == State::Resident) {
+        const Decoded& d = *chunk.decoded;
+        for (int y = 0; y < h; ++y) {
+            std::uint64_t bits = 0;
+            if (type == Tile::Floor)
+                bits = ~d.solid[y] & rowMask;
+            else
+                for (int x = 0; x < w; ++x)
+                    if (d.types[(y << ChunkShift) + x] == type) bits |= std::uint64_t(1) << x;
+
+            int inRow = std::popcount(bits);
+            if (n >= seen && n < seen + inRow) {
+                for (int skip = n - seen; skip > 0; --skip)
+                    bits &= bits - 1;
+                return (y << ChunkShift) + std::countr_zero(bits);
+            }
+            seen += inRow;
+        }
+        return -1;
+    }
+
+    // Compressed: the runs matching `type`, cut into rows and clipped to the map
+    int i = 0;
+    for (std::size_t r = 0; r < chunk.packed.size(); r += 2) {
+        int run = chunk.packed[r] + 1;
+        if (chunk.packed[r + 1] == type) {
+            for (int k = i; k < i + run;) {
+                int y = k >> ChunkShift;
+                int rowEnd = std::min(i + run, (y + 1) << ChunkShift);
+                int end = std::min(rowEnd, (y << ChunkShift) + w);
+                if (y < h && k < end) {
+                    if (n >= seen && n < seen + (end - k))
+                        return k + (n - seen);
+                    seen += end - k;
+                }
+                k = rowEnd;
+            }
+        }
+        i += run;
+    }
+    return -1;
+}
+
+std::size_t TileMap::countTiles(std::uint8_t type) const {
+    std::size_t n = 0;
+    forEachTile(type, [&](int, int) { ++n; });
+    return n;
+}
@@ -0,0 +1,260 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Snapshot.hpp"
+
+// One bit per tile, laid out as rows of 64-bit words.
+// Storage is paged in 64x64 tile blocks (one word per page row) that are only
+// allocated once a bit in them is set, so a huge, mostly untouched floor costs
+// next to nothing. Clears, unions and span tests work a word (64 tiles) at a
+// time; bits past the right edge are never set, so whole-word tests never see
+// phantom tiles.
+class TileBits {
+public:
+    TileBits() = default;
+    TileBits(int width, int height) { resize(width, height); }
+
+    void resize(int width, int height); // also clears
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getWordsPerRow() const { return wordsPerRow; }
+
+    // Out of range reads as false
+    bool test(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return false;
+        return (word(y, x >> 6) >> (x & 63)) & 1u;
+    }
+    void set(int x, int y) { mutableWord(y, x >> 6) |= bit(x); }
+    void reset(int x, int y) {
+        if (Page* page = pages[pageIndex(y, x >> 6)].get())
+            (*page)[y & 63] &= ~bit(x);
+    }
+
+    void clear(); // releases every page
+    void unionWith(const TileBits& other); // same size only
+
+    // Inclusive span [x0, x1] on row y, clipped to the row
+    bool anyInSpan(int y, int x0, int x1) const;
+    void clearSpan(int y, int x0, int x1);
+    int countInSpan(int y, int x0, int x1) const;
+
+    bool none() const;
+    std::size_t count() const;
+    std::size_t getAllocatedBytes() const;
+
+    // Size, then which pages exist and their words; untouched pages cost a byte
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+
+    // Calls fn(x) for every set bit in [x0, x1] on row y, left to right
+    template <typename Fn>
+    void forEachInSpan(int y, int x0, int x1, Fn&& fn) const {
+        if (!clipSpan(y, x0, x1)) return;
+        for (int w = x0 >> 6; w <= (x1 >> 6); ++w) {
+            std::uint64_t bits = word(y, w) & spanMask(w, x0, x1);
+            while (bits) {
+                fn((w << 6) + std::countr_zero(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+private:
+    using Page = std::array<std::uint64_t, 64>;
+
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0; // also pages per page row
+    std::vector<std::unique_ptr<Page>> pages;
+
+    std::size_t pageIndex(int y, int w) const { return static_cast<std::size_t>(y >> 6) * wordsPerRow + w; }
+    static std::uint64_t bit(int x) { return std::uint64_t(1) << (x & 63); }
+
+    std::uint64_t word(int y, int w) const {
+        const Page* page = pages[pageIndex(y, w)].get();
+        return page ? (*page)[y & 63] : 0;
+    }
+    std::uint64_t& mutableWord(int y, int w);
+
+    bool clipSpan(int y, int& x0, int& x1) const;
+
+    // Bits of word w that fall inside [x0, x1]
+    static std::uint64_t spanMask(int w, int x0, int x1) {
+        int lo = x0 > (w << 6) ? x0 & 63 : 0;
+        int hi = x1 < (w << 6) + 63 ? x1 & 63 : 63;
+        std::uint64_t upto = hi == 63 ? ~std::uint64_t(0) : (std::uint64_t(1) << (hi + 1)) - 1;
+        return upto & (~std::uint64_t(0) << lo);
+    }
+};
+
+namespace Tile {
+    inline constexpr std::uint8_t Floor = 0;
+    inline constexpr std::uint8_t Wall = 1;
+}
+
+// Tile types of one floor, one byte per tile, stored in ChunkSize x ChunkSize
+// chunks that are each in one of three states:
+//   Uniform    - every tile the same type; no storage at all
+//   Resident   - decoded bytes plus a solidity bitset, one word per chunk row
+//   Compressed - run-length encoded bytes
+// makeResident() keeps the chunks around the player decoded; the rest are
+// compressed least-recently-used first once more than the budget are decoded.
+//
+// Reads are const and never change a chunk's state, so they are safe from
+// worker threads and correct in every state; only resident chunks are fast.
+// Writes decode the chunk first and must happen on one thread.
+class TileMap {
+public:
+    static constexpr int ChunkShift = 6;
+    static constexpr int ChunkSize = 1 << ChunkShift; // one bitset word per chunk row
+
+    TileMap() = default;
+    TileMap(int width, int height, std::uint8_t type = Tile::Wall) { reset(width, height, type); }
+
+    // New dimensions, every tile `type`; no chunk is decoded afterwards
+    void reset(int width, int height, std::uint8_t type);
+    // Every tile `type`; resident chunks stay decoded so regenerating a
+    // floor of the same size reuses their buffers
+    void fill(std::uint8_t type);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChunksX() const { return chunksX; }
+    int getChunksY() const { return chunksY; }
+
+    // Out of range reads as Wall / solid
+    std::uint8_t get(int x, int y) const;
+    bool isSolid(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return true;
+        const Chunk& chunk = chunks[chunkIndex(x >> ChunkShift, y >> ChunkShift)];
+        if (chunk.state == State::Resident)
+            return (chunk.decoded->solid[y & (ChunkSize - 1)] >> (x & (ChunkSize - 1))) & 1u;
+        return get(x, y) != Tile::Floor;
+    }
+
+    // Inclusive tile rectangle; anything outside the map counts as solid
+    bool anySolidInRect(int x0, int y0, int x1, int y1) const;
+
+    // Tile types of `count` tiles from (x, y) rightwards into out; whole
+    // chunk rows at a time, so it is the cheap way to copy a region
+    void copyRow(int y, int x, int count, std::uint8_t* out) const;
+
+    void set(int x, int y, std::uint8_t type) {
+        int index = chunkIndex(x >> ChunkShift, y >> ChunkShift);
+        Chunk* chunk = &chunks[index];
+        if (chunk->state != State::Resident) {
+            if (chunk->state == State::Uniform && chunk->uniform == type) return;
+            chunk = &decode(index);
+        }
+
+        int lx = x & (ChunkSize - 1), ly = y & (ChunkSize - 1);
+        chunk->decoded->types[(ly << ChunkShift) + lx] = type;
+        if (type == Tile::Floor) chunk->decoded->solid[ly] &= ~(std::uint64_t(1) << lx);
+        else chunk->decoded->solid[ly] |= std::uint64_t(1) << lx;
+    }
+
+    // Decodes the inclusive chunk box and keeps it decoded (pinned) until the
+    // next call, compressing other chunks to stay within the budget
+    void makeResident(int chunkX0, int chunkY0, int chunkX1, int chunkY1);
+    bool isChunkResident(int chunkX, int chunkY) const;
+    void setResidentBudget(std::size_t chunkCount);
+
+    std::size_t getResidentCount() const { return resident.size(); }
+    std::size_t getCompressedBytes() const;
+    std::size_t countTiles(std::uint8_t type) const;
+
+    // Chunks are saved in whatever state they are in; resident ones are
+    // restored decoded (but unpinned), so loading never re-encodes anything
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+
+    // Tiles of `type` in one chunk, and where the n-th of them is (counting
+    // row by row) as (y << ChunkShift) + x inside the chunk, or -1 if there
+    // are n or fewer. Resident chunks count a row per popcount for Floor.
+    int countInChunk(int chunkX, int chunkY, std::uint8_t type) const;
+    int findInChunk(int chunkX, int chunkY, std::uint8_t type, int n) const;
+
+    // Calls fn(x, y) for every tile of `type`, chunk by chunk
+    template <typename Fn>
+    void forEachTile(std::uint8_t type, Fn&& fn) const {
+        for (int cy = 0; cy < chunksY; ++cy)
+            for (int cx = 0; cx < chunksX; ++cx)
+                forEachTileInChunk(cx, cy, type, fn);
+    }
+
+    // Likewise for one chunk, row by row
+    template <typename Fn>
+    void forEachTileInChunk(int cx, int cy, std::uint8_t type, Fn&& fn) const {
+        const Chunk& chunk = chunks[chunkIndex(cx, cy)];
+        int x0 = cx << ChunkShift, y0 = cy << ChunkShift;
+        int w = chunkWidth(cx), h = chunkHeight(cy);
+
+        if (chunk.state == State::Uniform) {
+            if (chunk.uniform != type) return;
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x) fn(x0 + x, y0 + y);
+        }
+        else if (chunk.state == State::Resident) {
+            const std::uint8_t* types = chunk.decoded->types.data();
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x)
+                    if (types[(y << ChunkShift) + x] == type) fn(x0 + x, y0 + y);
+        }
+        else {
+            // Walk the runs without decoding
+            int i = 0;
+            for (std::size_t r = 0; r < chunk.packed.size(); r += 2) {
+                int run = chunk.packed[r] + 1;
+                if (chunk.packed[r + 1] == type) {
+                    for (int k = i; k < i + run; ++k) {
+                        int x = k & (ChunkSize - 1), y = k >> ChunkShift;
+                        if (x < w && y < h) fn(x0 + x, y0 + y);
+                    }
+                }
+                i += run;
+            }
+        }
+    }
+
+private:
+    enum class State : std::uint8_t { Uniform, Resident, Compressed };
+
+    struct Decoded {
+        std::array<std::uint8_t, ChunkSize * ChunkSize> types;
+        std::array<std::uint64_t, ChunkSize> solid;
+    };
+
+    struct Chunk {
+        State state = State::Uniform;
+        std::uint8_t uniform = Tile::Wall;
+        std::uint64_t lastUse = 0;
+        std::unique_ptr<Decoded> decoded;
+        std::vector<std::uint8_t> packed; // (run length - 1, type) pairs
+    };
+
+    int width = 0;
+    int height = 0;
+    int chunksX = 0;
+    int chunksY = 0;
+    std::vector<Chunk> chunks;
+    std::vector<int> resident; // chunk indices currently decoded
+    std::size_t budget = 64;
+    std::uint64_t useClock = 0;
+    int pinX0 = 0, pinY0 = 0, pinX1 = -1, pinY1 = -1;
+
+    int chunkIndex(int cx, int cy) const { return cy * chunksX + cx; }
+    int chunkWidth(int cx) const { return std::min(ChunkSize, width - (cx << ChunkShift)); }
+    int chunkHeight(int cy) const { return std::min(ChunkSize, height - (cy << ChunkShift)); }
+    bool isPinned(int index) const;
+    int selectInChunk(int chunkX, int chunkY, std::uint8_t type, int n, int& seen) const;
+
+    Chunk& decode(int index);
+    void compress(int index);
+    void enforceBudget(int keep = -1);
+};
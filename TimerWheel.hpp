@@ -0,0 +1,199 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "Snapshot.hpp"
+
+struct TimerId {
+    static constexpr std::uint32_t InvalidIndex = 0xFFFFFFFF;
+
+    std::uint32_t index = InvalidIndex;
+    std::uint32_t generation = 0;
+
+    bool isValid() const { return index != InvalidIndex; }
+};
+
+// Hashed timer wheel driven by simulation ticks.
+// A timer lands in bucket (deadline % WheelSize); each advance() only looks
+// at the bucket for the new tick, so the cost is proportional to the timers
+// that are due (plus long timers passing through on an earlier lap), not to
+// the number of timers or entities. Timers further out than one lap just
+// stay in their bucket until their lap comes round.
+//
+// Ids are generational: cancelling or firing bumps the generation, so a
+// stale id can be cancelled again safely and never hits a newer timer.
+template <typename Payload>
+class TimerWheel {
+public:
+    static constexpr std::uint32_t WheelSize = 256; // ~4 s at 60 ticks/s
+
+    TimerWheel() : buckets(WheelSize) {}
+
+    std::uint64_t now() const { return currentTick; }
+
+    // Fires on the first advance() whose tick is >= deadline, but never
+    // during the advance() that is currently running.
+    TimerId schedule(std::uint64_t deadline, const Payload& payload) {
+        if (deadline <= currentTick)
+            deadline = currentTick + 1;
+
+        std::uint32_t index;
+        if (!freeList.empty()) {
+            index = freeList.back();
+            freeList.pop_back();
+        }
+        else {
+            index = static_cast<std::uint32_t>(timers.size());
+            timers.push_back({});
+        }
+
+        Timer& t = timers[index];
+        t.deadline = deadline;
+        t.payload = payload;
+        t.active = true;
+        TimerId id{ index, t.generation };
+        buckets[deadline % WheelSize].push_back(id);
+        ++activeCount;
+        return id;
+    }
+
+    TimerId scheduleIn(std::uint64_t ticks, const Payload& payload) {
+        return schedule(currentTick + ticks, payload);
+    }
+
+    // Safe on invalid, fired or already cancelled ids
+    void cancel(TimerId& id) {
+        if (isPending(id)) {
+            release(id.index);
+        }
+        id = {};
+    }
+
+    bool isPending(TimerId id) const {
+        return id.index < timers.size() && timers[id.index].active && timers[id.index].generation == id.generation;
+    }
+
+    // Steps the wheel to `tick`, calling onFire(const Payload&) for every
+    // timer that comes due, in deadline order and, within a tick, in the
+    // order they were scheduled.
+    template <typename Fn>
+    void advance(std::uint64_t tick, Fn&& onFire) {
+        while (currentTick < tick) {
+            ++currentTick;
+            if (activeCount == 0) {
+                currentTick = tick;
+                break;
+            }
+
+            // Swap out so timers scheduled from callbacks can't land in the
+            // list being walked
+            firing.clear();
+            std::swap(firing, buckets[currentTick % WheelSize]);
+
+            for (TimerId id : firing) {
+                if (!isPending(id)) continue; // cancelled
+                if (timers[id.index].deadline != currentTick) { // a later lap
+                    buckets[currentTick % WheelSize].push_back(id);
+                    continue;
+                }
+
+                Payload payload = timers[id.index].payload;
+                release(id.index);
+                onFire(payload);
+            }
+        }
+    }
+
+    // Drops every timer and restarts the clock at `tick`
+    void reset(std::uint64_t tick) {
+        for (std::uint32_t i = 0; i < timers.size(); ++i) {
+            if (timers[i].active)
+                release(i);
+        }
+        for (auto& bucket : buckets) bucket.clear();
+        currentTick = tick;
+    }
+
+    std::size_t size() const { return activeCount; }
+
+    // The whole wheel, so TimerIds held elsewhere stay valid across a load
+    void writeSnapshot(SnapshotWriter& out) const {
+        out.write(currentTick);
+
+        // Laid out like writeArray(timers), but each timer is copied into a
+        // zeroed one first: Timer has tail padding that would otherwise
+        // carry whatever was in memory into the snapshot
+        out.write(static_cast<std::uint64_t>(timers.size()));
+        for (const Timer& t : timers) {
+            Timer clean;
+            std::memset(static_cast<void*>(&clean), 0, sizeof(clean));
+            clean.deadline = t.deadline;
+            clean.payload = t.payload;
+            clean.generation = t.generation;
+            clean.active = t.active;
+            out.write(clean);
+        }
+        out.writeArray(freeList);
+        for (const auto& bucket : buckets)
+            out.writeArray(bucket);
+    }
+
+    // validPayload(const Payload&) vets each timer's payload, which came in
+    // as raw bytes
+    template <typename Fn>
+    bool readSnapshot(SnapshotReader& in, Fn&& validPayload) {
+        in.read(currentTick);
+        in.readArray(timers);
+        in.readArray(freeList);
+        for (auto& bucket : buckets)
+            in.readArray(bucket);
+        if (!in.ok()) return false;
+
+        bool consistent = true;
+        for (const Timer& t : timers)
+            consistent = consistent && isValidBool(t.active) && validPayload(t.payload);
+        for (std::uint32_t index : freeList)
+            consistent = consistent && index < timers.size() && !timers[index].active;
+        for (const auto& bucket : buckets)
+            for (TimerId id : bucket)
+                consistent = consistent && id.index < timers.size();
+        if (!consistent) {
+            in.fail();
+            timers.clear();
+            freeList.clear();
+            for (auto& bucket : buckets) bucket.clear();
+            activeCount = 0;
+            return false;
+        }
+
+        activeCount = 0;
+        for (const Timer& t : timers)
+            if (t.active) ++activeCount;
+        firing.clear();
+        return true;
+    }
+
+private:
+    struct Timer {
+        std::uint64_t deadline = 0;
+        Payload payload{};
+        std::uint32_t generation = 0;
+        bool active = false;
+    };
+
+    std::vector<Timer> timers;
+    std::vector<std::uint32_t> freeList;
+    std::vector<std::vector<TimerId>> buckets;
+    std::vector<TimerId> firing;
+    std::uint64_t currentTick = 0;
+    std::size_t activeCount = 0;
+
+    void release(std::uint32_t index) {
+        Timer& t = timers[index];
+        t.active = false;
+        ++t.generation;
+        freeList.push_back(index);
+        --activeCount;
+    }
+};
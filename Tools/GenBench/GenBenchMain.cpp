@@ -0,0 +1,170 @@
+#include "Dungeon.hpp"
+#include "Random.hpp"
+#include "WorkerPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+// Generates lots of seeded floors across all cores and reports how
+// Dungeon::generate behaves: time percentiles, how many rooms it managed to
+// place, how much floor it carved, and whether all floor is connected.
+// usage: GenBench [floors] [threads] [firstSeed] [width] [height]
+//
+// Floor i uses run seed firstSeed + i with the same key the Simulation uses
+// for floor 1, so a failing seed reproduces with `Headless <ticks> <seed>`.
+// Failing seeds are written to genbench_failures.txt.
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::size_t Grain = 512; // floors per parallelFor chunk
+
+    struct FloorResult {
+        std::uint32_t nanos = 0;
+        std::uint32_t floorTiles = 0;
+        std::uint32_t rooms = 0;
+        bool connected = false;
+    };
+
+    // Flood fills from the first floor tile (4-neighbour, like the no
+    // corner cutting rule in FlowField) and compares against the total
+    struct ConnectivityCheck {
+        std::vector<std::uint8_t> seen;
+        std::vector<std::int64_t> stack;
+
+        bool run(const TileMap& map, std::size_t floorTiles) {
+            const std::int64_t width = map.getWidth();
+            seen.assign(static_cast<std::size_t>(width) * map.getHeight(), 0);
+            stack.clear();
+
+            map.forEachTile(Tile::Floor, [&](int x, int y) {
+                if (!stack.empty()) return;
+                std::int64_t i = y * width + x;
+                seen[i] = 1;
+                stack.push_back(i);
+            });
+
+            std::size_t reached = 0;
+            while (!stack.empty()) {
+                std::int64_t tile = stack.back();
+                stack.pop_back();
+                reached++;
+
+                int x = static_cast<int>(tile % width);
+                int y = static_cast<int>(tile / width);
+                const int nx[4] = { x - 1, x + 1, x, x };
+                const int ny[4] = { y, y, y - 1, y + 1 };
+                for (int d = 0; d < 4; ++d) {
+                    if (map.isSolid(nx[d], ny[d])) continue;
+                    std::int64_t n = ny[d] * width + nx[d];
+                    if (seen[n]) continue;
+                    seen[n] = 1;
+                    stack.push_back(n);
+                }
+            }
+            return reached == floorTiles && floorTiles > 0;
+        }
+    };
+
+    std::uint64_t seedFor(std::uint64_t firstSeed, std::size_t i) {
+        return firstSeed + i;
+    }
+
+    template <typename T>
+    T percentile(const std::vector<T>& sorted, double p) {
+        if (sorted.empty()) return T{};
+        std::size_t i = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(i, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t floors = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    std::uint64_t firstSeed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+    int width = argc > 4 ? std::atoi(argv[4]) : Constants::Map::DEFAULT_MAP_WIDTH;
+    int height = argc > 5 ? std::atoi(argv[5]) : Constants::Map::DEFAULT_MAP_HEIGHT;
+
+    WorkerPool pool(threads);
+    std::vector<FloorResult> results(floors);
+
+    auto start = Clock::now();
+
+    pool.parallelFor(floors, Grain, [&](std::size_t begin, std::size_t end) {
+        // Dungeon is heavy enough to reuse across a chunk
+        Dungeon dungeon;
+        ConnectivityCheck check;
+
+        for (std::size_t i = begin; i < end; ++i) {
+            RandomStream rng(RandomStream::deriveKey(seedFor(firstSeed, i), RngStreamId::Generation, 1));
+
+            auto t0 = Clock::now();
+            dungeon.generate(rng, width, height);
+            auto t1 = Clock::now();
+
+            const TileMap& map = dungeon.getMap();
+            std::size_t floorTiles = map.countTiles(Tile::Floor);
+
+            FloorResult& r = results[i];
+            r.nanos = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            r.floorTiles = static_cast<std::uint32_t>(floorTiles);
+            r.rooms = static_cast<std::uint32_t>(dungeon.getRooms().size());
+            r.connected = check.run(map, floorTiles);
+        }
+    });
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<std::uint32_t> nanos;
+    std::vector<std::uint32_t> tiles;
+    // The room cap scales with floor area
+    std::size_t maxRooms = 0;
+    for (const FloorResult& r : results) maxRooms = std::max<std::size_t>(maxRooms, r.rooms);
+    std::vector<std::size_t> roomCounts(std::max<std::size_t>(maxRooms, MAX_ROOMS) + 1);
+    std::vector<std::uint64_t> failing;
+    nanos.reserve(floors);
+    tiles.reserve(floors);
+
+    for (std::size_t i = 0; i < floors; ++i) {
+        const FloorResult& r = results[i];
+        nanos.push_back(r.nanos);
+        tiles.push_back(r.floorTiles);
+        roomCounts[r.rooms]++;
+        if (!r.connected) failing.push_back(seedFor(firstSeed, i));
+    }
+    std::sort(nanos.begin(), nanos.end());
+    std::sort(tiles.begin(), tiles.end());
+
+    std::printf("floors:        %zu on %u threads, %.2f s (%.0f floors/s)\n",
+        floors, pool.getThreadCount(), seconds, seconds > 0.0 ? floors / seconds : 0.0);
+
+    std::printf("\ngenerate() us: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+        percentile(nanos, 0.5) / 1000.0, percentile(nanos, 0.9) / 1000.0,
+        percentile(nanos, 0.99) / 1000.0, percentile(nanos, 0.999) / 1000.0,
+        (nanos.empty() ? 0 : nanos.back()) / 1000.0);
+
+    std::printf("floor tiles:   min %u  p10 %u  p50 %u  p90 %u  max %u (of %lld, %dx%d)\n",
+        tiles.empty() ? 0u : tiles.front(), percentile(tiles, 0.1), percentile(tiles, 0.5),
+        percentile(tiles, 0.9), tiles.empty() ? 0u : tiles.back(),
+        static_cast<long long>(width) * height, width, height);
+
+    std::printf("\n%5s %10s %8s\n", "rooms", "floors", "share");
+    for (std::size_t n = 0; n < roomCounts.size(); ++n) {
+        std::printf("%5zu %10zu %7.3f%%\n", n, roomCounts[n],
+            floors > 0 ? 100.0 * roomCounts[n] / floors : 0.0);
+    }
+
+    std::printf("\ndisconnected:  %zu\n", failing.size());
+    if (!failing.empty()) {
+        std::ofstream out("genbench_failures.txt");
+        for (std::uint64_t seed : failing)
+            out << seed << "\n";
+        std::printf("failing seeds written to genbench_failures.txt (first: %llu)\n",
+            static_cast<unsigned long long>(failing.front()));
+    }
+
+    return failing.empty() ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include "Simulation.hpp"
+#include "SaveSystem.hpp"
+#include "Constants.hpp"
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Runs the simulation without a window as fast as it will go.
+// usage: Headless [ticks] [seed] [width] [height]
+//
+// Input comes from a dumb autopilot: wander in a random direction for a
+// while, swing whenever possible, take the stairs when allowed and restart
+// on death. Good enough for soak tests and profiling. The same seed gives
+// the same floors.
+//
+// A twin simulation gets the same input for the first SnapshotCheckTicks,
+// then both are snapshotted: the bytes must match exactly, or state (or
+// uninitialized padding) leaks into save files. A mismatch fails the run.
+namespace {
+    constexpr long long SnapshotCheckTicks = 3000;
+
+    std::vector<std::uint8_t> snapshotOf(const Simulation& sim) {
+        std::vector<std::uint8_t> bytes;
+        SnapshotWriter writer(bytes);
+        sim.writeSnapshot(writer);
+        return bytes;
+    }
+
+    // Offset of the first differing byte, or -1
+    long long firstDifference(const std::vector<std::uint8_t>& a, const std::vector<std::uint8_t>& b) {
+        std::size_t n = std::min(a.size(), b.size());
+        for (std::size_t i = 0; i < n; ++i)
+            if (a[i] != b[i]) return static_cast<long long>(i);
+        return a.size() == b.size() ? -1 : static_cast<long long>(n);
+    }
+}
+
+int main(int argc, char** argv) {
+    long long ticks = argc > 1 ? std::atoll(argv[1]) : 100000;
+    std::uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+    int width = argc > 3 ? std::atoi(argv[3]) : Constants::Map::DEFAULT_MAP_WIDTH;
+    int height = argc > 4 ? std::atoi(argv[4]) : Constants::Map::DEFAULT_MAP_HEIGHT;
+    const float dt = Constants::Sim::TickDt;
+
+    Simulation sim(seed, { width, height });
+    auto twin = std::make_unique<Simulation>(seed, sf::Vector2i{ width, height });
+    long long snapshotDiff = -1;
+    RandomStream pilotRng(seed);
+
+    int dir = 0;
+    int holdTicks = 0;
+    int deaths = 0;
+    int bestFloor = 1;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (long long t = 0; t < ticks; ++t) {
+        if (holdTicks-- <= 0) {
+            dir = pilotRng.uniformInt(0, 7);
+            holdTicks = pilotRng.uniformInt(10, 90);
+        }
+
+        SimInput input;
+        input.up = dir == 0 || dir == 4 || dir == 5;
+        input.down = dir == 1 || dir == 6 || dir == 7;
+        input.left = dir == 2 || dir == 4 || dir == 6;
+        input.right = dir == 3 || dir == 5 || dir == 7;
+        input.attack = true;
+        input.advanceFloor = sim.canAdvanceFloor();
+        input.restart = sim.getState() == Simulation::GameState::Dead;
+
+        sim.step(input, dt);
+        if (twin) {
+            twin->step(input, dt);
+            if (t + 1 == std::min(ticks, SnapshotCheckTicks)) {
+                snapshotDiff = firstDifference(snapshotOf(sim), snapshotOf(*twin));
+                twin.reset();
+            }
+        }
+
+        if (sim.getEvents().runEnded)
+            deaths++;
+        bestFloor = std::max(bestFloor, sim.getFloorNumber());
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    // Round trip the final state through a quick-save
+    SaveSystem saves;
+    bool saved = saves.quickSave(sim, "headless_quicksave.bin");
+    bool loaded = saved && saves.quickLoad(sim, "headless_quicksave.bin");
+
+    const FloorSwapStats& swaps = sim.getFloorSwapStats();
+    std::cout << "ticks:        " << ticks << "\n"
+        << "wall time:    " << seconds << " s\n"
+        << "ticks/sec:    " << (seconds > 0.0 ? ticks / seconds : 0.0) << "\n"
+        << "deaths:       " << deaths << "\n"
+        << "best floor:   " << bestFloor << "\n"
+        << "kills (run):  " << sim.getEnemiesDefeated() << "\n"
+        << "floor size:   " << sim.getDungeon().getWidth() << "x" << sim.getDungeon().getHeight()
+        << ", " << sim.getDungeon().getMap().getResidentCount() << " chunks resident\n"
+        << "floor swaps:  " << swaps.swaps << " (" << swaps.prefetched << " prefetched), max "
+        << swaps.maxMillis << " ms\n"
+        << "quick-save:   " << (loaded ? "" : "FAILED, ") << saves.getLastSize() / 1024 << " KB, save "
+        << saves.getLastSaveMillis() << " ms, load " << saves.getLastLoadMillis() << " ms\n"
+        << "snapshots:    ";
+    if (snapshotDiff < 0)
+        std::cout << "twin runs match byte for byte\n";
+    else
+        std::cout << "twin runs DIFFER at byte " << snapshotDiff << "\n";
+    return snapshotDiff < 0 ? 0 : 1;
+}
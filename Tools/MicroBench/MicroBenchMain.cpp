@@ -0,0 +1,378 @@
+#include "Dungeon.hpp"
+#include "Enemy.hpp"
+#include "FlowField.hpp"
+#include "FrameArena.hpp"
+#include "Loot.hpp"
+#include "Random.hpp"
+#include "SpatialHash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Times the inner loops of the simulation one at a time, swept over enemy
+// count and map size where those matter, writes the results as JSON and
+// compares them against a baseline from an earlier run.
+// usage: MicroBench [--out file] [--baseline file] [--threshold percent]
+//                   [--filter text] [--quick]
+//
+// Each case is timed in batches big enough to measure, five times over; the
+// median is the result. A case more than `threshold` (default 10) percent
+// slower than its baseline is flagged and makes the exit code 1, so a
+// before/after pair of runs shows what an optimisation bought. Results
+// default to microbench.json; pass it back as --baseline next time.
+//
+// Enemies are packed around the player the way a horde fight looks, since
+// that is where these loops get expensive.
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string outPath = "microbench.json";
+        std::string baselinePath;
+        double threshold = 10.0;
+        std::string filter;
+        double minSampleSeconds = 0.04;
+        int samples = 5;
+    };
+
+    struct Result {
+        std::string name;
+        std::string params;
+        double nsPerOp = 0.0;
+        double minNsPerOp = 0.0;
+        std::uint64_t ops = 0; // per sample
+    };
+
+    // Results land here so the optimiser can't drop the work
+    volatile std::uint64_t sink = 0;
+    void consume(std::uint64_t value) { sink = sink + value; }
+
+    const int EnemyCounts[] = { 16, 256, 4096 };
+    const sf::Vector2i MapSizes[] = { { 100, 72 }, { 400, 288 }, { 1000, 720 } };
+
+    std::string mapParam(sf::Vector2i size) {
+        return "map=" + std::to_string(size.x) + "x" + std::to_string(size.y);
+    }
+
+    std::string enemyParam(int enemies) {
+        return " enemies=" + std::to_string(enemies);
+    }
+
+    // batch(n) performs n operations. Doubles n until one batch takes long
+    // enough to time, then keeps the median and best of `samples` batches.
+    template <typename Batch>
+    void measure(const Options& opt, std::vector<Result>& results, const std::string& name,
+        const std::string& params, Batch&& batch) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos)
+            return;
+
+        auto timeBatch = [&](std::uint64_t n) {
+            auto start = Clock::now();
+            batch(n);
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        };
+
+        std::uint64_t ops = 1;
+        while (timeBatch(ops) < opt.minSampleSeconds && ops < (1ull << 40))
+            ops *= 2;
+
+        std::vector<double> ns;
+        for (int i = 0; i < opt.samples; ++i)
+            ns.push_back(timeBatch(ops) * 1e9 / ops);
+        std::sort(ns.begin(), ns.end());
+
+        Result r{ name, params, ns[ns.size() / 2], ns.front(), ops };
+        std::printf("%-28s %-30s %12.1f ns/op\n", r.name.c_str(), r.params.c_str(), r.nsPerOp);
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+
+    // A generated floor with the player in the middle of its first room and
+    // tiles within reach of them, for packing enemies around
+    struct Floor {
+        Dungeon dungeon;
+        sf::Vector2i size;
+        sf::Vector2f player;
+        sf::Vector2i playerTile;
+        std::pmr::vector<sf::Vector2f> nearTiles;
+
+        explicit Floor(sf::Vector2i mapSize) : size(mapSize) {
+            RandomStream rng(RandomStream::deriveKey(1, RngStreamId::Generation, 1));
+            dungeon.generate(rng, size.x, size.y);
+
+            const Room& room = dungeon.getRooms().front();
+            playerTile = { room.centerX(), room.centerY() };
+            player = { (playerTile.x + 0.5f) * TILE_SIZE, (playerTile.y + 0.5f) * TILE_SIZE };
+            dungeon.setFocus(playerTile.x, playerTile.y);
+
+            SpawnQuery near;
+            near.awayFrom = player;
+            near.maxDistance = 12.f * TILE_SIZE;
+            dungeon.sampleFloorTiles(rng, 4096, near, nearTiles);
+        }
+
+        // i-th horde position: tiles near the player, reused with a small
+        // offset once there are more enemies than tiles
+        sf::Vector2f hordePosition(std::size_t i) const {
+            sf::Vector2f p = nearTiles[i % nearTiles.size()];
+            float offset = static_cast<float>((i / nearTiles.size()) % 4) * 4.f;
+            return p + sf::Vector2f{ offset, offset };
+        }
+    };
+
+    struct Horde {
+        std::vector<std::unique_ptr<Enemy>> enemies;
+        SpatialHash hash{ TILE_SIZE };
+
+        Horde(const Floor& floor, int count) {
+            for (int i = 0; i < count; ++i) {
+                auto& e = enemies.emplace_back(std::make_unique<Enemy>(floor.hordePosition(i), floor.dungeon));
+                e->spatialProxy = hash.insert(e->getBounds(), e.get());
+            }
+        }
+    };
+
+    void benchCanMoveTo(const Options& opt, std::vector<Result>& results, const Floor& floor) {
+        for (int count : EnemyCounts) {
+            Horde horde(floor, count);
+            const sf::Vector2f moves[4] = { { 1.6f, 0.f }, { 0.f, 1.6f }, { -1.6f, 0.f }, { 0.f, -1.6f } };
+            measure(opt, results, "Entity::canMoveTo", mapParam(floor.size) + enemyParam(count), [&](std::uint64_t n) {
+                std::uint64_t free = 0;
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    const Enemy& e = *horde.enemies[i % horde.enemies.size()];
+                    free += e.canMoveTo(e.nextPositionWithMove(moves[i & 3]), floor.dungeon.getMap(), horde.hash);
+                }
+                consume(free);
+            });
+        }
+    }
+
+    void benchLineOfSight(const Options& opt, std::vector<Result>& results, const Floor& floor) {
+        // Pairs between the player and tiles around them, as enemies would ask
+        measure(opt, results, "Dungeon::lineOfSightClear", mapParam(floor.size), [&](std::uint64_t n) {
+            std::uint64_t clear = 0;
+            for (std::uint64_t i = 0; i < n; ++i)
+                clear += floor.dungeon.lineOfSightClear(floor.player, floor.nearTiles[i % floor.nearTiles.size()]);
+            consume(clear);
+        });
+    }
+
+    // Stands in for the per-enemy visibility/pursuit check: decide() is what
+    // every enemy runs each tick to see whether and where it can reach the player
+    void benchEnemyDecide(const Options& opt, std::vector<Result>& results, const Floor& floor) {
+        FlowField pursuit;
+        pursuit.update(floor.dungeon.getMap(), floor.playerTile.x, floor.playerTile.y, floor.dungeon.getActiveRegion());
+
+        for (int count : EnemyCounts) {
+            Horde horde(floor, count);
+            measure(opt, results, "Enemy::decide", mapParam(floor.size) + enemyParam(count), [&](std::uint64_t n) {
+                std::uint64_t moving = 0;
+                for (std::uint64_t i = 0; i < n; ++i)
+                    moving += horde.enemies[i % horde.enemies.size()]->decide(floor.player, pursuit, 1.f / 60.f).moveCount;
+                consume(moving);
+            });
+        }
+    }
+
+    void benchFlowField(const Options& opt, std::vector<Result>& results, const Floor& floor) {
+        // Goal alternates between two tiles so every update is a rebuild
+        FlowField pursuit;
+        sf::Vector2i goals[2] = { floor.playerTile, floor.playerTile + sf::Vector2i{ 1, 0 } };
+        measure(opt, results, "FlowField::update", mapParam(floor.size), [&](std::uint64_t n) {
+            std::uint64_t rebuilt = 0;
+            for (std::uint64_t i = 0; i < n; ++i)
+                rebuilt += pursuit.update(floor.dungeon.getMap(), goals[i & 1].x, goals[i & 1].y, floor.dungeon.getActiveRegion());
+            consume(rebuilt);
+        });
+    }
+
+    void benchMarkVisible(const Options& opt, std::vector<Result>& results, Floor& floor) {
+        for (int radius : { 2, 5, 10 }) {
+            measure(opt, results, "Dungeon::markVisible", mapParam(floor.size) + " radius=" + std::to_string(radius),
+                [&](std::uint64_t n) {
+                    std::uint64_t revealed = 0;
+                    for (std::uint64_t i = 0; i < n; ++i) {
+                        sf::Vector2f p = floor.nearTiles[i % floor.nearTiles.size()];
+                        revealed += floor.dungeon.markVisible(static_cast<int>(p.x / TILE_SIZE), static_cast<int>(p.y / TILE_SIZE), radius);
+                    }
+                    consume(revealed);
+                });
+        }
+    }
+
+    void benchGenerate(const Options& opt, std::vector<Result>& results, sf::Vector2i size) {
+        Dungeon dungeon;
+        std::uint64_t seed = 1;
+        measure(opt, results, "Dungeon::generate", mapParam(size), [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                RandomStream rng(RandomStream::deriveKey(seed++, RngStreamId::Generation, 1));
+                dungeon.generate(rng, size.x, size.y);
+            }
+            consume(dungeon.getRooms().size());
+        });
+    }
+
+    // getFloorTiles() is gone; spawning samples floor tiles from the tile map
+    void benchSampleFloorTiles(const Options& opt, std::vector<Result>& results, const Floor& floor) {
+        for (int count : EnemyCounts) {
+            RandomStream rng(7);
+            std::pmr::vector<sf::Vector2f> out;
+            SpawnQuery query;
+            query.awayFrom = floor.player;
+            query.minDistance = 200.f;
+            measure(opt, results, "Dungeon::sampleFloorTiles", mapParam(floor.size) + enemyParam(count), [&](std::uint64_t n) {
+                std::uint64_t found = 0;
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    out.clear();
+                    found += floor.dungeon.sampleFloorTiles(rng, static_cast<std::size_t>(count), query, out);
+                }
+                consume(found);
+            });
+        }
+    }
+
+    void benchRollDrops(const Options& opt, std::vector<Result>& results) {
+        RandomStream rng(11);
+        LootSystem loot(rng);
+        FrameArena arena; // as in Simulation::step
+        const char* names[] = { "common", "elite", "boss" };
+        for (std::size_t r = 0; r < EnemyRarityCount; ++r) {
+            measure(opt, results, "LootSystem::rollDrops", std::string("rarity=") + names[r], [&](std::uint64_t n) {
+                std::uint64_t drops = 0;
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    drops += loot.rollDrops(static_cast<EnemyRarity>(r), arena.resource()).size();
+                    arena.reset();
+                }
+                consume(drops);
+            });
+        }
+    }
+
+    // The hit test in Simulation::handlePlayerAttack (it moved there from
+    // Game): spatial query around the player, closest point on each enemy
+    void benchAttackQuery(const Options& opt, std::vector<Result>& results, const Floor& floor) {
+        constexpr float AttackRadius = 40.f;
+        for (int count : EnemyCounts) {
+            Horde horde(floor, count);
+            measure(opt, results, "handlePlayerAttack hit test", mapParam(floor.size) + enemyParam(count), [&](std::uint64_t n) {
+                std::uint64_t hits = 0;
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    sf::Vector2f center = floor.nearTiles[i % floor.nearTiles.size()];
+                    sf::FloatRect area{ center - sf::Vector2f{ AttackRadius, AttackRadius },
+                        { 2.f * AttackRadius, 2.f * AttackRadius } };
+                    horde.hash.query(area, [&](SpatialHash::ProxyId id) {
+                        sf::FloatRect b = horde.hash.getBounds(id);
+                        float dx = center.x - std::clamp(center.x, b.position.x, b.position.x + b.size.x);
+                        float dy = center.y - std::clamp(center.y, b.position.y, b.position.y + b.size.y);
+                        hits += dx * dx + dy * dy <= AttackRadius * AttackRadius;
+                    });
+                }
+                consume(hits);
+            });
+        }
+    }
+
+    void writeJson(const std::string& path, const std::vector<Result>& results) {
+        std::ofstream out(path);
+        out << "{\n  \"version\": 1,\n  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            char line[512];
+            std::snprintf(line, sizeof(line),
+                "    { \"name\": \"%s\", \"params\": \"%s\", \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"ops\": %llu }%s\n",
+                r.name.c_str(), r.params.c_str(), r.nsPerOp, r.minNsPerOp,
+                static_cast<unsigned long long>(r.ops), i + 1 < results.size() ? "," : "");
+            out << line;
+        }
+        out << "  ]\n}\n";
+    }
+
+    // Reads back what writeJson wrote: one result object per line
+    std::map<std::string, double> readBaseline(const std::string& path) {
+        std::map<std::string, double> baseline;
+        std::ifstream in(path);
+        std::string line;
+
+        auto stringField = [&](const char* key) -> std::string {
+            std::string tag = std::string("\"") + key + "\": \"";
+            std::size_t at = line.find(tag);
+            if (at == std::string::npos) return {};
+            at += tag.size();
+            return line.substr(at, line.find('"', at) - at);
+        };
+
+        while (std::getline(in, line)) {
+            std::size_t at = line.find("\"ns_per_op\": ");
+            if (at == std::string::npos) continue;
+            baseline[stringField("name") + "|" + stringField("params")] = std::atof(line.c_str() + at + 13);
+        }
+        return baseline;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--out" && hasValue) opt.outPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) opt.baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) opt.threshold = std::atof(argv[++i]);
+        else if (arg == "--filter" && hasValue) opt.filter = argv[++i];
+        else if (arg == "--quick") { opt.minSampleSeconds = 0.01; opt.samples = 3; }
+        else {
+            std::fprintf(stderr, "usage: MicroBench [--out file] [--baseline file] [--threshold percent] [--filter text] [--quick]\n");
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+    benchRollDrops(opt, results);
+    for (sf::Vector2i size : MapSizes) {
+        Floor floor(size);
+        benchGenerate(opt, results, size);
+        benchCanMoveTo(opt, results, floor);
+        benchLineOfSight(opt, results, floor);
+        benchEnemyDecide(opt, results, floor);
+        benchFlowField(opt, results, floor);
+        benchMarkVisible(opt, results, floor);
+        benchSampleFloorTiles(opt, results, floor);
+        benchAttackQuery(opt, results, floor);
+    }
+
+    writeJson(opt.outPath, results);
+    std::printf("\nresults written to %s\n", opt.outPath.c_str());
+
+    if (opt.baselinePath.empty())
+        return 0;
+
+    std::map<std::string, double> baseline = readBaseline(opt.baselinePath);
+    if (baseline.empty()) {
+        std::fprintf(stderr, "no results in baseline %s\n", opt.baselinePath.c_str());
+        return 2;
+    }
+
+    int regressions = 0;
+    std::printf("\n%-28s %-30s %12s %12s %8s\n", "vs baseline", "", "ns/op", "baseline", "change");
+    for (const Result& r : results) {
+        auto it = baseline.find(r.name + "|" + r.params);
+        if (it == baseline.end() || it->second <= 0.0) continue;
+
+        double change = 100.0 * (r.nsPerOp - it->second) / it->second;
+        const char* flag = "";
+        if (change > opt.threshold) { flag = "  REGRESSION"; regressions++; }
+        else if (change < -opt.threshold) flag = "  faster";
+        std::printf("%-28s %-30s %12.1f %12.1f %+7.1f%%%s\n", r.name.c_str(), r.params.c_str(),
+            r.nsPerOp, it->second, change, flag);
+    }
+    std::printf("\n%d regression%s over %.0f%%\n", regressions, regressions == 1 ? "" : "s", opt.threshold);
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+#include "Replay.hpp"
+#include "Simulation.hpp"
+#include "Constants.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Plays a recorded session back without a window, as fast as it will go,
+// and checks it ends where the recording did.
+// usage: Replay [file] [slowest]
+//
+// Prints the `slowest` (default 10) ticks with their tick number and floor,
+// so a reported stutter can be found and then profiled by running this under
+// a profiler.
+namespace {
+    struct TickTime {
+        double micros;
+        std::size_t tick;
+        int floor;
+    };
+}
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "replay.bin";
+    std::size_t slowest = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+
+    Replay replay;
+    if (!replay.load(path)) {
+        std::cerr << path << " is missing or not a replay\n";
+        return 1;
+    }
+
+    Simulation sim(replay.getSeed(), replay.getFloorSize());
+    if (!replay.applyStart(sim)) {
+        std::cerr << "start snapshot doesn't load\n";
+        return 1;
+    }
+
+    const std::size_t ticks = replay.getTickCount();
+    const float dt = Constants::Sim::TickDt;
+    std::vector<TickTime> times;
+    times.reserve(ticks);
+    int deaths = 0;
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    for (std::size_t t = 0; t < ticks; ++t) {
+        auto t0 = Clock::now();
+        sim.step(replay.inputAt(t), dt);
+        auto t1 = Clock::now();
+
+        times.push_back({ std::chrono::duration<double, std::micro>(t1 - t0).count(), t, sim.getFloorNumber() });
+        if (sim.getEvents().runEnded)
+            deaths++;
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    double recorded = ticks * static_cast<double>(dt);
+    bool matches = Replay::outcomeOf(sim) == replay.getOutcome();
+
+    std::cout << "replay:       " << path << " (seed " << replay.getSeed() << ", "
+        << replay.getFloorSize().x << "x" << replay.getFloorSize().y
+        << (replay.hasSnapshot() ? ", from a snapshot" : "") << ")\n"
+        << "ticks:        " << ticks << " (" << recorded << " s of play)\n"
+        << "wall time:    " << seconds << " s, " << (seconds > 0.0 ? recorded / seconds : 0.0) << "x real time\n"
+        << "deaths:       " << deaths << "\n"
+        << "final floor:  " << sim.getFloorNumber() << ", kills " << sim.getEnemiesDefeated() << "\n"
+        << "outcome:      " << (matches ? "matches the recording" : "DIFFERS from the recording") << "\n";
+
+    slowest = std::min(slowest, times.size());
+    std::partial_sort(times.begin(), times.begin() + slowest, times.end(),
+        [](const TickTime& a, const TickTime& b) { return a.micros > b.micros; });
+    if (slowest > 0)
+        std::cout << "\nslowest ticks:\n";
+    for (std::size_t i = 0; i < slowest; ++i)
+        std::cout << "  tick " << times[i].tick << " (floor " << times[i].floor << "): " << times[i].micros << " us\n";
+
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include "RunHistory.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Reads a run history in one streaming pass and prints distributions.
+// usage: RunStats [history]
+//        RunStats --import <runs.txt> [history]
+//
+// Runs imported from runs.txt only know their floor and kill count, so they
+// count towards those two and nothing else.
+namespace {
+
+    struct Metric {
+        const char* name;
+        Histogram values;
+    };
+
+    void printMetric(const Metric& m) {
+        const Histogram& h = m.values;
+        std::printf("%-16s %9llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", m.name,
+            static_cast<unsigned long long>(h.count()), h.mean(), h.min(),
+            h.percentile(0.5), h.percentile(0.9), h.percentile(0.99), h.max());
+    }
+
+    const char* killerName(std::uint8_t killedBy) {
+        switch (killedBy) {
+        case 1: return "common enemy";
+        case 2: return "elite enemy";
+        case 3: return "boss";
+        default: return "unknown";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--import") == 0) {
+        if (argc < 3) {
+            std::fprintf(stderr, "usage: RunStats --import <runs.txt> [history]\n");
+            return 2;
+        }
+        std::string path = argc > 3 ? argv[3] : RunHistory::DefaultPath;
+        int imported = RunHistory::importText(argv[2], path);
+        if (imported < 0) {
+            std::fprintf(stderr, "couldn't import %s into %s\n", argv[2], path.c_str());
+            return 1;
+        }
+        std::printf("imported %d runs into %s\n", imported, path.c_str());
+        return 0;
+    }
+
+    std::string path = argc > 1 ? argv[1] : RunHistory::DefaultPath;
+    RunHistory::Reader reader;
+    if (!reader.open(path)) {
+        std::fprintf(stderr, "%s is missing or not a run history\n", path.c_str());
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    Metric floors{ "floors reached", Histogram(1.0, 1024) };
+    Metric kills{ "kills", Histogram(1.0, 1 << 16) };
+    Metric runTime{ "run time (s)", Histogram(1.0, 1 << 16) };
+    Metric peakEnemies{ "peak enemies", Histogram(1.0, 1 << 16) };
+    Metric frameP50{ "frame p50 (ms)", Histogram(0.1, 10000) };
+    Metric frameP99{ "frame p99 (ms)", Histogram(0.1, 10000) };
+
+    std::uint64_t runs = 0;
+    std::uint64_t imported = 0;
+    std::uint64_t killsByRarity[EnemyRarityCount] = {};
+    std::uint64_t deaths[EnemyRarityCount + 1] = {};
+
+    RunSummary run;
+    while (reader.next(run)) {
+        runs++;
+        floors.values.add(run.floorsReached);
+        kills.values.add(run.totalKills);
+        if (run.flags & RunSummary::Imported) {
+            imported++;
+            continue;
+        }
+
+        runTime.values.add(run.runSeconds);
+        peakEnemies.values.add(run.peakEnemies);
+        frameP50.values.add(run.frameP50Ms);
+        frameP99.values.add(run.frameP99Ms);
+        for (std::size_t i = 0; i < EnemyRarityCount; ++i)
+            killsByRarity[i] += run.killsByRarity[i];
+        deaths[run.killedBy <= EnemyRarityCount ? run.killedBy : 0]++;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("runs:            %llu (%llu imported from runs.txt), read in %.3f s\n",
+        static_cast<unsigned long long>(runs), static_cast<unsigned long long>(imported), seconds);
+    if (runs == 0)
+        return 0;
+
+    std::printf("\n%-16s %9s %9s %9s %9s %9s %9s %9s\n", "", "runs", "mean", "min", "p50", "p90", "p99", "max");
+    for (const Metric* m : { &floors, &kills, &runTime, &peakEnemies, &frameP50, &frameP99 })
+        printMetric(*m);
+
+    std::uint64_t tracked = runs - imported;
+    if (tracked > 0) {
+        std::printf("\nkills by rarity: common %llu  elite %llu  boss %llu\n",
+            static_cast<unsigned long long>(killsByRarity[0]),
+            static_cast<unsigned long long>(killsByRarity[1]),
+            static_cast<unsigned long long>(killsByRarity[2]));
+
+        std::printf("\n%-16s %9s %8s\n", "killed by", "runs", "share");
+        for (std::uint8_t i = 0; i <= EnemyRarityCount; ++i)
+            std::printf("%-16s %9llu %7.2f%%\n", killerName(i),
+                static_cast<unsigned long long>(deaths[i]), 100.0 * deaths[i] / tracked);
+    }
+
+    // Floors reached, as a bar chart
+    const auto& buckets = floors.values.getBuckets();
+    std::uint64_t most = 0;
+    for (std::uint64_t n : buckets) most = std::max(most, n);
+    std::printf("\n%5s %9s\n", "floor", "runs");
+    for (std::size_t f = 0; f < buckets.size(); ++f) {
+        if (buckets[f] == 0) continue;
+        int bar = static_cast<int>(40 * buckets[f] / most);
+        std::printf("%5zu %9llu %.*s\n", f, static_cast<unsigned long long>(buckets[f]), std::max(bar, 1),
+            "########################################");
+    }
+
+    return 0;
+}
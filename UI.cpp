@@ -1,127 +1,234 @@
 #include "UI.hpp"
 #include "Dungeon.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
-UI::UI(const Dungeon& dungeon) : dungeonRef(dungeon) {
-    minimapTexture = sf::RenderTexture(sf::Vector2u{ MAP_WIDTH, MAP_HEIGHT });
-
-
-    minimapBg.setSize(sf::Vector2f{ MAP_WIDTH * MINIMAP_SCALE + 4, MAP_HEIGHT * MINIMAP_SCALE + 4 });
+UI::UI(const Dungeon& dungeon, const sf::Font& font) : dungeonRef(dungeon), hud(font) {
     minimapBg.setFillColor(sf::Color(20, 20, 20, 200));
     minimapBg.setPosition(sf::Vector2f{ 8, 8 });
 
+    healthBarBg.setSize({ 200.f, 20.f });
+    healthBarBg.setFillColor(sf::Color(50, 0, 0));
+    healthBarFill.setSize({ 0.f, 20.f });
+    healthBarFill.setFillColor(sf::Color::Red);
+
     regenerateMinimap();
+
+    floorLabel = hud.addLabel(18, sf::Color::White);
+    toKillLabel = hud.addLabel(18, sf::Color::White);
+    killedLabel = hud.addLabel(18, sf::Color::White);
+    advanceLabel = hud.addLabel(18, sf::Color::Green);
+    deathLabel = hud.addLabel(64, sf::Color::Red, true);
+    restartLabel = hud.addLabel(32, sf::Color::Red);
+    floorSwapLabel = hud.addLabel(14, sf::Color(160, 160, 160));
 }
 
-void UI::draw(sf::RenderWindow& window, const Player& player) {
-    if (minimapDirty) {
-        regenerateMinimap();
+void UI::draw(sf::RenderWindow& window, const Player& player, const EnemyPool& enemies) {
+    PROFILE_SCOPE("UI::draw");
+    sf::Vector2i playerTile(player.getCenter() / TILE_SIZE);
+    if (minimapDirty || needsMinimapScroll(playerTile)) {
+        updateMinimap(playerTile);
         minimapDirty = false;
     }
     // draw minimap frame
     window.draw(minimapBg);
+    PROFILE_COUNT(DrawCalls, 1);
 
     // draw minimap
-    if (minimapSprite.has_value())
+    if (minimapSprite.has_value()) {
         window.draw(*minimapSprite);
+        PROFILE_COUNT(DrawCalls, 1);
+    }
 
-    // draw player marker on minimap
-    sf::RectangleShape playerMarker(sf::Vector2f{ 5.f, 5.f });
-    playerMarker.setFillColor(sf::Color::Green);
-    playerMarker.setPosition(sf::Vector2f{
-        minimapSprite->getPosition().x + (player.getPosition().x / TILE_SIZE) * MINIMAP_SCALE,
-        minimapSprite->getPosition().y + (player.getPosition().y / TILE_SIZE) * MINIMAP_SCALE
-        });
-    window.draw(playerMarker);
+    drawMinimapMarkers(window, player, enemies);
     drawPlayerHealth(window, player);
+}
 
-    if (bossMarkerWorldPos.has_value() && minimapSprite.has_value()) {
-
-        sf::CircleShape bossMarker(4.f);
-        bossMarker.setFillColor(sf::Color::Red);
-        bossMarker.setOrigin({ 4.f, 4.f });
+namespace {
+    void appendRect(sf::VertexArray& va, sf::Vector2f pos, sf::Vector2f size, sf::Color color) {
+        sf::Vector2f b{ pos.x + size.x, pos.y };
+        sf::Vector2f c{ pos.x + size.x, pos.y + size.y };
+        sf::Vector2f d{ pos.x, pos.y + size.y };
+        va.append({ pos, color }); va.append({ b, color }); va.append({ c, color });
+        va.append({ pos, color }); va.append({ c, color }); va.append({ d, color });
+    }
 
-        sf::Vector2f minimapPos = minimapSprite->getPosition();
+    void appendDisc(sf::VertexArray& va, sf::Vector2f center, float radius, sf::Color color) {
+        constexpr int Segments = 12;
+        for (int i = 0; i < Segments; ++i) {
+            float a0 = 6.2831853f * i / Segments;
+            float a1 = 6.2831853f * (i + 1) / Segments;
+            va.append({ center, color });
+            va.append({ center + sf::Vector2f{ std::cos(a0), std::sin(a0) } * radius, color });
+            va.append({ center + sf::Vector2f{ std::cos(a1), std::sin(a1) } * radius, color });
+        }
+    }
+}
 
-        sf::Vector2f bossTilePos = {
-            bossMarkerWorldPos->x / TILE_SIZE,
-            bossMarkerWorldPos->y / TILE_SIZE
-        };
+// Player, boss and visible enemies in one vertex array / one draw call
+void UI::drawMinimapMarkers(sf::RenderWindow& window, const Player& player, const EnemyPool& enemies) {
+    minimapMarkers.clear();
+    sf::Vector2f minimapPos = minimapSprite->getPosition();
+
+    auto toMinimap = [&](sf::Vector2f worldPos) {
+        return sf::Vector2f{
+            minimapPos.x + (worldPos.x / TILE_SIZE - minimapOrigin.x) * MINIMAP_SCALE,
+            minimapPos.y + (worldPos.y / TILE_SIZE - minimapOrigin.y) * MINIMAP_SCALE };
+    };
+
+    auto onMinimap = [&](sf::Vector2f worldPos) {
+        return sf::IntRect(minimapOrigin, minimapSize).contains(sf::Vector2i(worldPos / TILE_SIZE));
+    };
+
+    for (const auto& enemy : enemies) {
+        if (enemy.isBoss()) continue; // has its own marker
+        sf::Vector2f pos = enemy.getPosition();
+        if (!dungeonRef.isTileCurrentlyVisible(static_cast<int>(pos.x / TILE_SIZE), static_cast<int>(pos.y / TILE_SIZE)))
+            continue;
+        appendRect(minimapMarkers, toMinimap(pos), { 3.f, 3.f }, sf::Color(255, 140, 0));
+    }
 
-        bossMarker.setPosition({
-            minimapPos.x + bossTilePos.x * MINIMAP_SCALE,
-            minimapPos.y + bossTilePos.y * MINIMAP_SCALE
-            });
+    appendRect(minimapMarkers, toMinimap(player.getPosition()), { 5.f, 5.f }, sf::Color::Green);
 
-        window.draw(bossMarker);
+    if (const Enemy* boss = enemies.get(bossMarker)) {
+        if (onMinimap(boss->getCenter()))
+            appendDisc(minimapMarkers, toMinimap(boss->getCenter()), 4.f, sf::Color::Red);
     }
+
+    window.draw(minimapMarkers);
+    PROFILE_COUNT(DrawCalls, 1);
 }
 
-void UI::regenerateMinimap() {
-    minimapTexture.clear(sf::Color::Black);
+// Map tile coordinates; the tile must be inside the minimap window
+void UI::writeMinimapTile(int x, int y) {
+    sf::Color c = dungeonRef.getMap().isSolid(x, y) ? sf::Color(80, 80, 80) : sf::Color(180, 180, 180);
 
-    sf::RectangleShape pixel(sf::Vector2f{ 1.f, 1.f });
-    const MapArray& map = dungeonRef.getMap();
+    std::size_t local = static_cast<std::size_t>(y - minimapOrigin.y) * minimapSize.x + (x - minimapOrigin.x);
+    std::uint8_t* px = &minimapPixels[local * 4];
+    px[0] = c.r; px[1] = c.g; px[2] = c.b; px[3] = c.a;
+}
 
-    const auto& discovered = dungeonRef.getDiscovered();
+// Upload the inclusive rectangle [x0..x1] x [y0..y1], in minimap pixels
+void UI::uploadMinimapRect(int x0, int y0, int x1, int y1) {
+    int w = x1 - x0 + 1;
+    int h = y1 - y0 + 1;
+
+    if (w == minimapSize.x) {
+        // Full rows are already contiguous
+        minimapTexture.update(&minimapPixels[static_cast<std::size_t>(y0) * minimapSize.x * 4],
+            sf::Vector2u(static_cast<unsigned>(w), static_cast<unsigned>(h)),
+            sf::Vector2u(0u, static_cast<unsigned>(y0)));
+        return;
+    }
 
-    for (int y = 0; y < MAP_HEIGHT; ++y) {
-        for (int x = 0; x < MAP_WIDTH; ++x) {
-            if (!discovered[y][x]) continue;
+    uploadScratch.resize(static_cast<std::size_t>(w) * h * 4);
+    for (int y = 0; y < h; ++y) {
+        const std::uint8_t* src = &minimapPixels[(static_cast<std::size_t>(y0 + y) * minimapSize.x + x0) * 4];
+        std::copy(src, src + w * 4, &uploadScratch[static_cast<std::size_t>(y) * w * 4]);
+    }
+    minimapTexture.update(uploadScratch.data(),
+        sf::Vector2u(static_cast<unsigned>(w), static_cast<unsigned>(h)),
+        sf::Vector2u(static_cast<unsigned>(x0), static_cast<unsigned>(y0)));
+}
 
-            pixel.setFillColor(map[y][x] == 1 ? sf::Color(80, 80, 80) : sf::Color(180, 180, 180));
-            pixel.setPosition(sf::Vector2f{ static_cast<float>(x), static_cast<float>(y) });
-            minimapTexture.draw(pixel);
-        }
+void UI::regenerateMinimap() {
+    PROFILE_SCOPE("UI::regenerateMinimap");
+    sf::Vector2i mapSize{ dungeonRef.getWidth(), dungeonRef.getHeight() };
+    sf::Vector2i size{
+        std::min(mapSize.x, Constants::UI::MinimapMaxWidth),
+        std::min(mapSize.y, Constants::UI::MinimapMaxHeight) };
+
+    if (size != minimapSize) {
+        minimapSize = size;
+        minimapTexture = sf::Texture(sf::Vector2u(size));
+        minimapPixels.resize(static_cast<std::size_t>(size.x) * size.y * 4);
+        minimapSprite.emplace(minimapTexture);
+        minimapSprite->setScale(sf::Vector2f{ MINIMAP_SCALE, MINIMAP_SCALE });
+        minimapSprite->setPosition(sf::Vector2f{ 10.f, 10.f });
+        minimapBg.setSize(sf::Vector2f{ size.x * MINIMAP_SCALE + 4, size.y * MINIMAP_SCALE + 4 });
+    }
+    minimapOrigin.x = std::clamp(minimapOrigin.x, 0, mapSize.x - size.x);
+    minimapOrigin.y = std::clamp(minimapOrigin.y, 0, mapSize.y - size.y);
+    minimapMapSize = mapSize;
+
+    // Opaque black for undiscovered tiles
+    for (std::size_t i = 0; i < minimapPixels.size(); i += 4) {
+        minimapPixels[i] = minimapPixels[i + 1] = minimapPixels[i + 2] = 0;
+        minimapPixels[i + 3] = 255;
     }
 
-    minimapTexture.display();
-    minimapSprite.emplace(minimapTexture.getTexture());
-    minimapSprite->setScale(sf::Vector2f{ MINIMAP_SCALE, MINIMAP_SCALE });
-    minimapSprite->setPosition(sf::Vector2f{ 10.f, 10.f });
-}
+    const TileBits& discovered = dungeonRef.getDiscovered();
+    for (int y = minimapOrigin.y; y < minimapOrigin.y + size.y; ++y) {
+        discovered.forEachInSpan(y, minimapOrigin.x, minimapOrigin.x + size.x - 1,
+            [&](int x) { writeMinimapTile(x, y); });
+    }
 
-void UI::markMinimapDirty() {
-    minimapDirty = true;
+    uploadMinimapRect(0, 0, size.x - 1, size.y - 1);
+    revealCursor = dungeonRef.getRevealLog().size();
+    minimapEpoch = dungeonRef.getDiscoveryEpoch();
 }
 
-void UI::drawPlayerHealth(sf::RenderWindow& window, const Player& player) {
-    float barWidth = 200.f;
-    float barHeight = 20.f;
-    float healthPercent = player.getHealthPercent();
+// Floors bigger than the minimap show a window around the player; it jumps
+// to re-centre once the player gets within a quarter of its edge
+bool UI::needsMinimapScroll(sf::Vector2i playerTile) const {
+    sf::Vector2i margin = minimapSize / 4;
+    bool scrollX = minimapSize.x < minimapMapSize.x &&
+        (playerTile.x < minimapOrigin.x + margin.x || playerTile.x >= minimapOrigin.x + minimapSize.x - margin.x);
+    bool scrollY = minimapSize.y < minimapMapSize.y &&
+        (playerTile.y < minimapOrigin.y + margin.y || playerTile.y >= minimapOrigin.y + minimapSize.y - margin.y);
+    return scrollX || scrollY;
+}
 
-    sf::RectangleShape bg({ barWidth, barHeight });
-    bg.setFillColor(sf::Color(50, 0, 0));
-    bg.setPosition(sf::Vector2f{ 10.f, window.getSize().y - 30.f });
+void UI::updateMinimap(sf::Vector2i playerTile) {
+    PROFILE_SCOPE("UI::updateMinimap");
+    sf::Vector2i mapSize{ dungeonRef.getWidth(), dungeonRef.getHeight() };
+    if (minimapEpoch != dungeonRef.getDiscoveryEpoch() || mapSize != minimapMapSize || needsMinimapScroll(playerTile)) {
+        minimapOrigin = playerTile - minimapSize / 2; // clamped by the rebuild
+        regenerateMinimap(); // new floor, restart or scroll
+        return;
+    }
 
-    sf::RectangleShape fill({ barWidth * healthPercent, barHeight });
-    fill.setFillColor(sf::Color::Red);
-    fill.setPosition(sf::Vector2f{ 10.f, window.getSize().y - 30.f });
+    const auto& log = dungeonRef.getRevealLog();
+    if (revealCursor >= log.size()) return;
+
+    const int width = dungeonRef.getWidth();
+    sf::IntRect window(minimapOrigin, minimapSize);
+    int minX = minimapSize.x, minY = minimapSize.y, maxX = -1, maxY = -1;
+    for (; revealCursor < log.size(); ++revealCursor) {
+        int x = log[revealCursor] % width;
+        int y = log[revealCursor] / width;
+        if (!window.contains({ x, y })) continue;
+
+        writeMinimapTile(x, y);
+        int lx = x - minimapOrigin.x, ly = y - minimapOrigin.y;
+        minX = std::min(minX, lx); maxX = std::max(maxX, lx);
+        minY = std::min(minY, ly); maxY = std::max(maxY, ly);
+    }
 
-    window.draw(bg);
-    window.draw(fill);
+    if (maxX >= 0)
+        uploadMinimapRect(minX, minY, maxX, maxY);
 }
 
-void UI::drawDeathScreen(sf::RenderWindow& window, const sf::Font& font)
-{
-    window.setView(window.getDefaultView());
-
-    sf::Text deathText(font, "YOU DIED", 64);
-    sf::FloatRect bounds = deathText.getGlobalBounds();
-    deathText.setFillColor(sf::Color::Red);
-    deathText.setStyle(sf::Text::Bold);
-    deathText.setPosition(sf::Vector2f{
-        (window.getSize().x - bounds.size.x) / 2.f,
-        (window.getSize().y - bounds.size.y) / 2.f - 30.f
-        });
-    sf::Text restartText(font, "press 'R' for restart", 32);
-    restartText.setFillColor(sf::Color::Red);
-    restartText.setPosition(sf::Vector2f{
-        (window.getSize().x - bounds.size.x) / 2.f,
-        (window.getSize().y - bounds.size.y) / 2.f + 40.f
-        });
+void UI::markMinimapDirty() {
+    minimapDirty = true;
+}
 
-    window.draw(deathText);
-    window.draw(restartText);
+void UI::drawPlayerHealth(sf::RenderWindow& window, const Player& player) {
+    // The shapes live on; the fill is only resized when health changes
+    sf::Vector2f barSize = healthBarBg.getSize();
+    float fillWidth = barSize.x * player.getHealthPercent();
+    if (healthBarFill.getSize().x != fillWidth)
+        healthBarFill.setSize({ fillWidth, barSize.y });
+
+    sf::Vector2f position{ 10.f, window.getSize().y - 30.f }; // the window may have been resized
+    healthBarBg.setPosition(position);
+    healthBarFill.setPosition(position);
+
+    window.draw(healthBarBg);
+    window.draw(healthBarFill);
+    PROFILE_COUNT(DrawCalls, 2);
 }
 
 void UI::drawWinScreen(sf::RenderWindow& window, const sf::Font& font)
@@ -147,56 +254,61 @@ void UI::drawWinScreen(sf::RenderWindow& window, const sf::Font& font)
     window.draw(restartText);
 }
 
-void UI::setBossMarker(const sf::Vector2f& worldPos) {
-    bossMarkerWorldPos = worldPos;
+void UI::setBossMarker(EnemyHandle boss) {
+    bossMarker = boss;
 }
 
 void UI::clearBossMarker() {
-    bossMarkerWorldPos.reset();
-}
-
-void UI::drawFloorCounter(sf::RenderWindow& window, int floor, const sf::Font& font) {
-    sf::Text text(font, "Floor " + std::to_string(floor), 18);
-    sf::FloatRect bounds = text.getGlobalBounds();
-    text.setFillColor(sf::Color::White);
-    text.setPosition(sf::Vector2f{
-        (window.getSize().x - bounds.size.x) * 0.5f,
-        8.f });
-
-    window.draw(text);
+    bossMarker = {};
 }
 
-void UI::drawEnemyCounter(sf::RenderWindow& window, int toKillThisFloor, int killedOverall, const sf::Font& font)
-{
-    sf::Text text(font, "Enemies to kill: " + std::to_string(toKillThisFloor), 18);
-    sf::FloatRect bounds = text.getGlobalBounds();
-    text.setFillColor(sf::Color::White);
-    text.setPosition(sf::Vector2f{
-        (window.getSize().x - bounds.size.x) * 0.35f,
-        40.f });
-
-    sf::Text text1(font, "Enemies killed: " + std::to_string(killedOverall), 18);
-    sf::FloatRect bounds1 = text1.getGlobalBounds();
-    text1.setFillColor(sf::Color::White);
-    text1.setPosition(sf::Vector2f{
-        (window.getSize().x - bounds1.size.x) * 0.35f,
-        24.f });
-
-    window.draw(text);
-    window.draw(text1);
-}
+void UI::drawHud(sf::RenderWindow& window, const HudState& state) {
+    PROFILE_SCOPE("UI::drawHud");
+    // Fixed strings are set on first use, once the font has been loaded
+    if (shownHud.floor < 0) {
+        hud.setString(advanceLabel, "Press T to advance to next floor!");
+        hud.setString(deathLabel, "YOU DIED");
+        hud.setString(restartLabel, "press 'R' for restart");
+    }
 
-void UI::drawAdvanceFloor(sf::RenderWindow& window, const sf::Font& font)
-{
-    sf::Text text(font, "Press T to advance to next floor!", 18);
-    sf::FloatRect bounds = text.getGlobalBounds();
-    text.setFillColor(sf::Color::Green);
-    text.setPosition(sf::Vector2f{
-        (window.getSize().x - bounds.size.x) * 0.5f,
-        700.f });
-    window.draw(text);
-}
+    // Strings (and so glyph layout) only change with their values
+    char text[64];
+    if (state.floor != shownHud.floor) {
+        std::snprintf(text, sizeof(text), "Floor %d", state.floor);
+        hud.setString(floorLabel, text);
+    }
+    if (state.enemiesToKill != shownHud.enemiesToKill) {
+        std::snprintf(text, sizeof(text), "Enemies to kill: %d", state.enemiesToKill);
+        hud.setString(toKillLabel, text);
+    }
+    if (state.enemiesKilled != shownHud.enemiesKilled) {
+        std::snprintf(text, sizeof(text), "Enemies killed: %d", state.enemiesKilled);
+        hud.setString(killedLabel, text);
+    }
+    if (state.floorSwapMicros != shownHud.floorSwapMicros || state.floorSwapPrefetched != shownHud.floorSwapPrefetched) {
+        std::snprintf(text, sizeof(text), "Floor swap: %.2f ms (%s)", state.floorSwapMicros / 1000.f,
+            state.floorSwapPrefetched ? "prefetched" : "built on the spot");
+        hud.setString(floorSwapLabel, text);
+    }
+    shownHud = state;
 
+    hud.setVisible(advanceLabel, state.showAdvance);
+    hud.setVisible(deathLabel, state.showDeath);
+    hud.setVisible(restartLabel, state.showDeath);
+    hud.setVisible(floorSwapLabel, state.floorSwapMicros >= 0);
 
+    // Positions are cheap to recompute; setPosition ignores non-changes
+    sf::Vector2f win(window.getSize());
+    hud.setPosition(floorLabel, { (win.x - hud.getSize(floorLabel).x) * 0.5f, 8.f });
+    hud.setPosition(toKillLabel, { (win.x - hud.getSize(toKillLabel).x) * 0.35f, 40.f });
+    hud.setPosition(killedLabel, { (win.x - hud.getSize(killedLabel).x) * 0.35f, 24.f });
+    hud.setPosition(advanceLabel, { (win.x - hud.getSize(advanceLabel).x) * 0.5f, 700.f });
+    hud.setPosition(floorSwapLabel, { win.x - hud.getSize(floorSwapLabel).x - 10.f, 8.f });
 
+    sf::Vector2f death = hud.getSize(deathLabel);
+    hud.setPosition(deathLabel, { (win.x - death.x) / 2.f, (win.y - death.y) / 2.f - 30.f });
+    hud.setPosition(restartLabel, { (win.x - death.x) / 2.f, (win.y - death.y) / 2.f + 40.f });
 
+    window.setView(window.getDefaultView());
+    hud.draw(window);
+}
@@ -1,30 +1,71 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
 #include "Player.hpp"
+#include "Enemy.hpp"
+#include "HudText.hpp"
 class Dungeon;
 
+// Values the HUD text shows; labels are only re-laid out when one changes
+struct HudState {
+    int floor = 0;
+    int enemiesToKill = 0;
+    int enemiesKilled = 0;
+    bool showAdvance = false;
+    bool showDeath = false;
+    int floorSwapMicros = -1; // how long the last floor took to start
+    bool floorSwapPrefetched = false;
+};
+
 class UI {
 public:
-    UI(const Dungeon& dungeon);
+    UI(const Dungeon& dungeon, const sf::Font& font);
 
-    void draw(sf::RenderWindow& window, const Player& player);
-    void regenerateMinimap(); // call only when dungeon changes 
-    void markMinimapDirty();  
+    void draw(sf::RenderWindow& window, const Player& player, const EnemyPool& enemies);
+    void regenerateMinimap(); // full rebuild from the discovered grid
+    void markMinimapDirty();  // new tiles revealed; picked up incrementally on next draw
     void drawPlayerHealth(sf::RenderWindow& window, const Player& player);
-	void drawDeathScreen(sf::RenderWindow& window, const sf::Font& font);
 	void drawWinScreen(sf::RenderWindow& window, const sf::Font& font);
-    void setBossMarker(const sf::Vector2f& worldPos);
+    void setBossMarker(EnemyHandle boss);
     void clearBossMarker();
-    void drawFloorCounter(sf::RenderWindow& window, int floor, const sf::Font& font);
-	void drawEnemyCounter(sf::RenderWindow& window, int toKillThisFloor, int killedOverall, const sf::Font& font);
-	void drawAdvanceFloor(sf::RenderWindow& window, const sf::Font& font);
+    void drawHud(sf::RenderWindow& window, const HudState& state);
 
 
 private:
-    sf::RenderTexture minimapTexture;
+    // Minimap pixels live on the CPU; only the rectangle covering newly
+    // revealed tiles is uploaded to the texture.
+    // Floors larger than the minimap show a window of it around the player.
+    std::vector<std::uint8_t> minimapPixels; // RGBA, minimapSize
+    std::vector<std::uint8_t> uploadScratch;
+    sf::Texture minimapTexture;
     std::optional<sf::Sprite> minimapSprite;
     sf::RectangleShape minimapBg;
+    sf::RectangleShape healthBarBg;
+    sf::RectangleShape healthBarFill;
+    sf::VertexArray minimapMarkers{ sf::PrimitiveType::Triangles };
     const Dungeon& dungeonRef;
+    sf::Vector2i minimapOrigin; // map tile shown at the top left
+    sf::Vector2i minimapSize;   // in tiles
+    sf::Vector2i minimapMapSize;
     bool minimapDirty = true;
-    std::optional<sf::Vector2f> bossMarkerWorldPos;
+    std::size_t revealCursor = 0;
+    std::uint32_t minimapEpoch = 0;
+    EnemyHandle bossMarker; // resolved against the pool every draw
+
+    HudText hud;
+    HudText::LabelId floorLabel;
+    HudText::LabelId toKillLabel;
+    HudText::LabelId killedLabel;
+    HudText::LabelId advanceLabel;
+    HudText::LabelId deathLabel;
+    HudText::LabelId restartLabel;
+    HudText::LabelId floorSwapLabel;
+    HudState shownHud{ -1, -1, -1 };
+
+    void updateMinimap(sf::Vector2i playerTile);
+    bool needsMinimapScroll(sf::Vector2i playerTile) const;
+    void writeMinimapTile(int x, int y);
+    void uploadMinimapRect(int x0, int y0, int x1, int y1);
+    void drawMinimapMarkers(sf::RenderWindow& window, const Player& player, const EnemyPool& enemies);
 };
@@ -0,0 +1,80 @@
+#include "WorkerPool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 1; i < threads; ++i)
+        workers.emplace_back([this] { workerLoop(); });
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers)
+        t.join();
+}
+
+void WorkerPool::run(std::size_t count, std::size_t grain, ChunkFn fn, void* context)
+{
+    if (count == 0) return;
+    grain = std::max<std::size_t>(grain, 1);
+
+    // Not worth waking anyone
+    if (workers.empty() || count <= grain) {
+        fn(context, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = fn;
+        jobContext = context;
+        jobCount = count;
+        jobGrain = grain;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busyWorkers = static_cast<unsigned>(workers.size());
+        ++jobGeneration;
+    }
+    wake.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busyWorkers == 0; });
+    job = nullptr;
+    jobContext = nullptr;
+}
+
+void WorkerPool::runChunks() {
+    while (true) {
+        std::size_t begin = nextIndex.fetch_add(jobGrain, std::memory_order_relaxed);
+        if (begin >= jobCount) break;
+        job(jobContext, begin, std::min(begin + jobGrain, jobCount));
+    }
+}
+
+void WorkerPool::workerLoop() {
+    std::uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkers;
+        }
+        done.notify_one();
+    }
+}
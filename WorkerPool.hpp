@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops inside one tick.
+// parallelFor() hands out index ranges from a shared counter to the workers
+// and the calling thread, and returns once every range is done, so callers
+// can treat it like a plain for loop over independent iterations.
+class WorkerPool {
+public:
+    // 0 = one thread per core, counting the caller
+    explicit WorkerPool(unsigned threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Calls fn(begin, end) over [0, count) in chunks of at most `grain`.
+    // fn is only referenced for the duration of the call, never copied, so
+    // handing over a lambda doesn't allocate.
+    template <typename Fn>
+    void parallelFor(std::size_t count, std::size_t grain, Fn&& fn) {
+        run(count, grain, [](void* context, std::size_t begin, std::size_t end) {
+            (*static_cast<std::remove_reference_t<Fn>*>(context))(begin, end);
+        }, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+    // Threads that take part in parallelFor, including the caller
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    using ChunkFn = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    // Current job, guarded by `mutex` except for the atomics
+    ChunkFn job = nullptr;
+    void* jobContext = nullptr;
+    std::size_t jobCount = 0;
+    std::size_t jobGrain = 1;
+    std::atomic<std::size_t> nextIndex{ 0 };
+    std::uint64_t jobGeneration = 0;
+    unsigned busyWorkers = 0;
+    bool stopping = false;
+
+    void run(std::size_t count, std::size_t grain, ChunkFn fn, void* context);
+    void workerLoop();
+    void runChunks();
+};